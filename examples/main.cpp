@@ -557,51 +557,18 @@ void print_u128(__int128 x) {
     std::cout << s << "\n";
 }
 
+// Merges the 18 shard checkpoints generateLookupNewHash2Corner leaves behind when it is interrupted into
+// DATA_PATH/newHashMap2CornersConstructedDepth<depth>.tbl, without holding the table in memory.
+// resumeLookupNewHash2Corner does the same in memory and generates any missing shard.
 void combineLookups(int depth) {
-    Lookup lookup;
+    const std::string title = "newHashMap2CornersConstructedDepth" + std::to_string(depth);
 
+    std::vector<std::string> shards;
     for (const char m : MoveConst::moves) {
-        std::string titlePartiallyConstructed = "PartiallyConstructed";
-        titlePartiallyConstructed += m;
-        auto path = std::string(DATA_PATH) + "/" + titlePartiallyConstructed + ".txt";
-        if (std::filesystem::exists(path)) {
-            std::cout << "Loading move " << m << " from file..\n";
-            Lookup::load(lookup.newHashMap2Corner, titlePartiallyConstructed);
-            continue;
-        }
-
-        std::unordered_map<__int128, std::vector<char>> partMap;
-        std::string title = "newHashMap2CornersMove";
-        title += m;
-        title += "Depth" + std::to_string(depth);
-        Lookup::load(partMap, title);
-
-        auto mapSize = partMap.size();
-        int i = 0;
-        for (auto &[key, vec] : partMap) {
-            if (i % 1000 == 0) {
-                std::cout << "Move: " << m << " | Progress: " << i << "/" << mapSize << " | " << 100.0 * static_cast<double>(i) / static_cast<double>(mapSize) << "%" << "           \r";
-            }
-            i++;
-
-            if (lookup.newHashMap2Corner.contains(key)) {
-                if (vec.size() < lookup.newHashMap2Corner[key].size()) {
-                    lookup.newHashMap2Corner[key] = vec;
-                }
-            } else {
-                lookup.newHashMap2Corner[key] = vec;
-            }
-        }
-
-        titlePartiallyConstructed = "PartiallyConstructed";
-        titlePartiallyConstructed += m;
-        Lookup::save(lookup.newHashMap2Corner, titlePartiallyConstructed);
+        shards.push_back(title + "Shard" + m);
     }
-    std::cout << "\nSaving map...";
 
-    std::string title = "newHashMap2CornersConstructed";
-    title += "Depth" + std::to_string(depth);
-    Lookup::save(lookup.newHashMap2Corner, title);
+    Lookup::combineOnDisk(shards, title, 10 * 1000 * 1000);
 }
 
 int main() {
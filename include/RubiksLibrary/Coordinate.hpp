@@ -0,0 +1,112 @@
+
+#ifndef RUBIKSSOLVER_COORDINATE_HPP
+#define RUBIKSSOLVER_COORDINATE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RubiksLibrary/CubieCube.hpp"
+
+// A perfect index for where a set of pieces is: every placement of the tracked corners and edges inside
+// their allowed slots gets its own number in [0, size()), so tables over it can be flat arrays.
+// The slots are ranked as a partial permutation (first piece's slot, then the second among the remaining
+// slots, ...) followed by one twist/flip digit per piece.
+class PieceCoordinate {
+public:
+    // An empty slot list means every slot of that kind.
+    PieceCoordinate(std::vector<int> cornerPieces, std::vector<int> edgePieces,
+                    std::vector<int> cornerSlots = {}, std::vector<int> edgeSlots = {});
+
+    uint64_t size() const;
+
+    // The tracked pieces must be inside the allowed slots.
+    uint64_t rank(const CubieCube &cube) const;
+
+    // A cube with the tracked pieces placed as described by coordinate. The other pieces fill the free
+    // slots in order without twist, so the result is not always a reachable cube.
+    CubieCube unrank(uint64_t coordinate) const;
+
+private:
+    std::vector<int> cornerPieces;
+    std::vector<int> edgePieces;
+    std::vector<int> cornerSlots;
+    std::vector<int> edgeSlots;
+
+    // Index of each slot in cornerSlots/edgeSlots.
+    std::array<uint8_t, 8> cornerSlotIndex{};
+    std::array<uint8_t, 12> edgeSlotIndex{};
+
+    uint64_t cornerPermutations;
+    uint64_t cornerTwists;
+    uint64_t edgePermutations;
+    uint64_t edgeFlips;
+};
+
+namespace CoordinateConst {
+    inline const PieceCoordinate crossAnd2Corners(
+        {CubieConst::twoCornerCorners.begin(), CubieConst::twoCornerCorners.end()},
+        {CubieConst::twoCornerEdges.begin(), CubieConst::twoCornerEdges.end()});
+
+    // hashNew3Corner adds the white-blue-orange corner and the blue-orange edge.
+    inline const PieceCoordinate crossAnd3Corners({0, 1, 2}, {0, 1, 2, 3, 4, 5, 6});
+
+    inline const PieceCoordinate firstTwoLayers({0, 1, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7});
+
+    // Only valid with the first two layers solved, the last layer pieces are ranked within the yellow slots.
+    inline const PieceCoordinate lastLayer({4, 5, 6, 7}, {8, 9, 10, 11}, {4, 5, 6, 7}, {8, 9, 10, 11});
+
+    // crossAnd2Corners split into parts small enough for move tables.
+    inline const PieceCoordinate crossEdges({}, {0, 1, 2, 3});
+    inline const PieceCoordinate slotEdges({}, {4, 5});
+    inline const PieceCoordinate twoCorners({0, 1}, {});
+}
+
+// next[coordinate * 18 + move] is the coordinate after turning 'A' + move.
+class CoordinateMoveTable {
+public:
+    std::vector<uint32_t> next;
+
+    uint32_t turn(const uint32_t coordinate, const int moveIndex) const {
+        return next[coordinate * 18 + moveIndex];
+    }
+
+    // Fills the table on one worker per hardware thread unless told otherwise.
+    static CoordinateMoveTable generate(const PieceCoordinate &coordinate, unsigned workers = 0);
+
+    // Reads DATA_PATH/title.bin, or generates the table and writes it there on the first run.
+    static CoordinateMoveTable loadOrGenerate(const PieceCoordinate &coordinate, const std::string &title);
+
+    void save(const std::string &title) const;
+    bool load(const std::string &title, uint64_t expectedSize);
+};
+
+// The cross + 2 corner state as three coordinates that are turned with one table load each.
+struct CrossAnd2CornersCoordinates {
+    uint32_t cross;
+    uint16_t slotEdges;
+    uint16_t corners;
+
+    explicit CrossAnd2CornersCoordinates(const CubieCube &cube);
+    // Inverse of key().
+    static CrossAnd2CornersCoordinates fromKey(uint64_t key);
+
+    void turnIndex(int moveIndex, const std::array<CoordinateMoveTable, 3> &tables);
+
+    // Unique key in [0, 190080 * 528 * 504). Not every key is a real state, the slot edges can't share a
+    // slot with the cross edges.
+    uint64_t key() const {
+        return (static_cast<uint64_t>(cross) * 528 + slotEdges) * 504 + corners;
+    }
+
+    // Gap-free index in [0, denseSize): the slot edges are ranked among the 8 slots the cross leaves free.
+    static constexpr uint64_t denseSize = 190080ULL * 224 * 504;
+    uint64_t denseIndex() const;
+
+    // Loaded (or generated) on first use.
+    static const std::array<CoordinateMoveTable, 3> &moveTables();
+};
+
+
+#endif //RUBIKSSOLVER_COORDINATE_HPP
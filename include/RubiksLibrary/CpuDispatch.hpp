@@ -0,0 +1,45 @@
+
+#ifndef RUBIKSSOLVER_CPUDISPATCH_HPP
+#define RUBIKSSOLVER_CPUDISPATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum CpuLevel {
+    Scalar,
+    SSE4,
+    AVX2,
+    AVX512
+};
+
+// Function pointers to the best implementation of each hot kernel for the selected CpuLevel.
+struct CubeKernels {
+    // Applies move 'A' + moveIndex to 64 packed facelets (16 bytes of zero padding).
+    void (*turn)(uint8_t *facelets, int moveIndex);
+    // Same value as RubiksCube::hashNew2Corner for the packed facelets.
+    __int128 (*hashNew2Corner)(const uint8_t *facelets);
+    // Index of key in keys[0, count), or count if it is missing.
+    size_t (*findKey)(const __int128 *keys, size_t count, __int128 key);
+};
+
+namespace CpuDispatch {
+    // The best level this CPU and OS support, checked with cpuid.
+    CpuLevel detect();
+
+    // The level in use. Chosen at startup from detect(), or from the environment variable
+    // RUBIKS_CPU_LEVEL (scalar, sse4, avx2 or avx512) when it is set. A level that is misspelled or
+    // unsupported is ignored with a warning.
+    CpuLevel level();
+
+    // Switches every kernel to the given level, for benchmarking. Throws if the CPU lacks it.
+    void force(CpuLevel level);
+
+    const CubeKernels &kernels();
+
+    std::string name(CpuLevel level);
+    CpuLevel parse(const std::string &name);
+}
+
+
+#endif //RUBIKSSOLVER_CPUDISPATCH_HPP
@@ -0,0 +1,100 @@
+
+#ifndef RUBIKSSOLVER_CUBIECUBE_HPP
+#define RUBIKSSOLVER_CUBIECUBE_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "RubiksLibrary/Move.hpp"
+#include "RubiksLibrary/RubiksCube.hpp"
+
+namespace CubieConst {
+    // Facelets of every corner slot. The white/yellow facelet comes first and the other two follow in the
+    // same turning direction for every slot, so a twisted corner is a rotation of this list.
+    constexpr std::array<std::array<unsigned char, 3>, 8> cornerFacelets = {{
+        { 5, 16, 15}, // 0 WBR
+        { 0, 10, 45}, // 1 WRG
+        { 7, 37, 18}, // 2 WOB
+        { 2, 47, 32}, // 3 WGO
+        {24, 13, 21}, // 4 YRB
+        {29, 40,  8}, // 5 YGR
+        {26, 23, 39}, // 6 YBO
+        {31, 34, 42}  // 7 YOG
+    }};
+
+    // Facelets of every edge slot, the white/yellow facelet first (blue/green for the middle layer).
+    constexpr std::array<std::array<unsigned char, 2>, 12> edgeFacelets = {{
+        { 3, 12}, //  0 WR
+        { 6, 17}, //  1 WB
+        { 1, 46}, //  2 WG
+        { 4, 35}, //  3 WO
+        {19, 14}, //  4 BR
+        {43,  9}, //  5 GR
+        {20, 38}, //  6 BO
+        {44, 33}, //  7 GO
+        {27, 11}, //  8 YR
+        {25, 22}, //  9 YB
+        {30, 41}, // 10 YG
+        {28, 36}  // 11 YO
+    }};
+
+    // Pieces tracked by RubiksCube::hashNew2Corner: the white cross, the two white-red corners and the
+    // two middle layer edges between them.
+    constexpr std::array<int, 2> twoCornerCorners = {0, 1};
+    constexpr std::array<int, 6> twoCornerEdges = {0, 1, 2, 3, 4, 5};
+
+    // moves[m][location] is where a piece at location (slot * size + orientation) goes with move m.
+    // The orientation is the index in the slot's facelet list holding the piece's first facelet.
+    template<size_t Slots, size_t Size>
+    constexpr std::array<std::array<uint8_t, Slots * Size>, 18> makePieceMoves(const std::array<std::array<unsigned char, Size>, Slots> &slotFacelets) {
+        std::array<std::array<uint8_t, Slots * Size>, 18> moves{};
+
+        for (int m = 0; m < 18; m++) {
+            const auto &source = RubiksConst::movePermutations[m];
+
+            for (size_t location = 0; location < Slots * Size; location++) {
+                const unsigned char from = slotFacelets[location / Size][location % Size];
+
+                int to = 0;
+                while (source[to] != from) { to++; }
+
+                for (size_t slot = 0; slot < Slots; slot++) {
+                    for (size_t k = 0; k < Size; k++) {
+                        if (slotFacelets[slot][k] == to) {
+                            moves[m][location] = static_cast<uint8_t>(slot * Size + k);
+                        }
+                    }
+                }
+            }
+        }
+
+        return moves;
+    }
+
+    constexpr std::array<std::array<uint8_t, 24>, 18> cornerMoves = makePieceMoves(cornerFacelets);
+    constexpr std::array<std::array<uint8_t, 24>, 18> edgeMoves = makePieceMoves(edgeFacelets);
+}
+
+// The cube as pieces instead of facelets. corners[p] is the location (slot * 3 + twist) of the corner that
+// belongs in slot p, edges[p] the location (slot * 2 + flip) of edge p. A move is one table lookup per piece.
+class CubieCube {
+public:
+    std::array<uint8_t, 8> corners{};
+    std::array<uint8_t, 12> edges{};
+
+    CubieCube();
+    explicit CubieCube(const std::array<short, 48> &cube);
+    explicit CubieCube(const RubiksCube &cube);
+
+    std::array<short, 48> toArray() const;
+
+    void turn(Move m);
+    void turnIndex(int moveIndex);
+
+    bool solved() const;
+    bool operator==(const CubieCube &other) const = default;
+
+};
+
+
+#endif //RUBIKSSOLVER_CUBIECUBE_HPP
@@ -0,0 +1,49 @@
+
+#ifndef RUBIKSSOLVER_EXTERNALTABLEBUILDER_HPP
+#define RUBIKSSOLVER_EXTERNALTABLEBUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RubiksLibrary/Move.hpp"
+
+// Builds a MappedTable file (DATA_PATH/title.tbl) from more (key, moves) records than fit in memory.
+// Records are collected until maxRecordsInMemory, then sorted, reduced to the shortest sequence per key
+// and written as a run file (DATA_PATH/title.run<N>). finish() merges all runs into the table, again
+// keeping the shortest sequence per key; on equal length the record added first wins.
+template<typename Key>
+class ExternalTableBuilder {
+public:
+    ExternalTableBuilder(std::string title, size_t maxRecordsInMemory);
+    ~ExternalTableBuilder();
+
+    ExternalTableBuilder(const ExternalTableBuilder &) = delete;
+    ExternalTableBuilder &operator=(const ExternalTableBuilder &) = delete;
+
+    void add(Key key, PackedMoves moves);
+
+    // Sorts and writes the records collected so far as a run, even if the buffer isn't full.
+    void spill();
+
+    // Merges the runs into the table, removes the run files and returns the number of keys.
+    uint64_t finish();
+
+    size_t numRuns() const { return runPaths.size(); }
+
+    struct Record {
+        Key key;
+        PackedMoves moves;
+    };
+
+private:
+    std::string title;
+    size_t maxRecordsInMemory;
+
+    std::vector<Record> buffer;
+    std::vector<std::string> runPaths;
+};
+
+
+#endif //RUBIKSSOLVER_EXTERNALTABLEBUILDER_HPP
@@ -0,0 +1,74 @@
+
+#ifndef RUBIKSSOLVER_FLATINDEX_HPP
+#define RUBIKSSOLVER_FLATINDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "RubiksLibrary/CpuDispatch.hpp"
+#include "RubiksLibrary/Move.hpp"
+
+namespace FlatIndexSearch {
+    // Index of key in the sorted keys[0, count), or count when it is missing. The halving loop compiles to
+    // conditional moves, so there is no branch to mispredict; 128-bit keys finish with a SIMD scan.
+    template<typename Key>
+    size_t find(const Key *keys, const size_t count, const Key key) {
+        if (count == 0) { return count; }
+
+        const Key *base = keys;
+        size_t n = count;
+        while (n > 8) {
+            const size_t half = n / 2;
+            base = (base[half] < key) ? base + half : base;
+            n -= half;
+        }
+
+        // The key, if present, is in base[0, n].
+        const size_t window = std::min(n + 1, static_cast<size_t>(keys + count - base));
+        if constexpr (std::is_same_v<Key, __int128>) {
+            const size_t i = CpuDispatch::kernels().findKey(base, window, key);
+            return i == window ? count : static_cast<size_t>(base - keys) + i;
+        } else {
+            for (size_t i = 0; i < window; i++) {
+                if (base[i] == key) { return static_cast<size_t>(base - keys) + i; }
+            }
+            return count;
+        }
+    }
+}
+
+// An immutable in-memory table: the keys in one array in Eytzinger (breadth-first search tree) order, so the
+// first levels of every search share a few hot cache lines and the next levels can be prefetched, and the
+// move sequences in a parallel array of PackedMoves.
+template<typename Key>
+class FlatIndex {
+public:
+    FlatIndex() = default;
+    explicit FlatIndex(const std::unordered_map<Key, PackedMoves> &map);
+
+    size_t size() const { return keys.empty() ? 0 : keys.size() - 1; }
+    size_t memoryUsage() const { return keys.size() * (sizeof(Key) + sizeof(PackedMoves)); }
+    // The longest stored sequence, the depth the table was generated to. Reads every value.
+    size_t maxLength() const;
+
+    bool contains(Key key) const;
+    std::optional<PackedMoves> find(Key key) const;
+    // find() for count keys at once. The searches go down the tree together, so the cache misses of one
+    // level overlap instead of following each other.
+    void findBatch(const Key *batch, size_t count, std::optional<PackedMoves> *out) const;
+
+private:
+    // 1-based, keys[0] is unused.
+    std::vector<Key> keys;
+    std::vector<PackedMoves> values;
+
+    size_t search(Key key) const;
+};
+
+
+#endif //RUBIKSSOLVER_FLATINDEX_HPP
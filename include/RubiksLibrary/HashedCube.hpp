@@ -0,0 +1,58 @@
+
+#ifndef RUBIKSSOLVER_HASHEDCUBE_HPP
+#define RUBIKSSOLVER_HASHEDCUBE_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "RubiksLibrary/Move.hpp"
+#include "RubiksLibrary/RubiksCube.hpp"
+
+namespace HashedConst {
+    // faceletDestinations[m][i] is where the sticker on facelet i goes with move m, the inverse of
+    // RubiksConst::movePermutations.
+    constexpr std::array<std::array<unsigned char, 48>, 18> makeFaceletDestinations() {
+        std::array<std::array<unsigned char, 48>, 18> destinations{};
+        for (int m = 0; m < 18; m++) {
+            for (int i = 0; i < 48; i++) {
+                destinations[m][RubiksConst::movePermutations[m][i]] = static_cast<unsigned char>(i);
+            }
+        }
+
+        return destinations;
+    }
+
+    constexpr std::array<std::array<unsigned char, 48>, 18> faceletDestinations = makeFaceletDestinations();
+
+    // Bit positions of the pieces hashNew2Corner tracks: the two corners, then the six edges.
+    constexpr std::array<int, 8> trackedPositions = {30, 42, 84, 90, 96, 102, 108, 114};
+}
+
+// Keeps RubiksCube::hashNew2Corner up to date while turning, without the facelets. Every piece is
+// represented by its reference facelet (the facelet holding its smallest color), which is all the hash
+// stores: the tracked pieces in their own fields, and the highest reference facelet of the untracked
+// pieces in field 0. A move remaps the 20 reference facelets and patches only the fields that changed.
+class HashedCube {
+public:
+    std::array<uint8_t, 8> tracked{};
+    std::array<uint8_t, 12> untracked{};
+    __int128 hash = 0;
+
+    HashedCube() = default;
+    explicit HashedCube(const std::array<short, 48> &cube);
+    explicit HashedCube(const RubiksCube &cube);
+
+    void turn(Move m);
+    void turnIndex(int moveIndex);
+
+    // Gap-free index of the tracked pieces in [0, denseSize), field 0 is left out. Every piece is ranked
+    // among the slots the earlier ones left free, the same range as CrossAnd2CornersCoordinates::denseIndex()
+    // but not the same numbering.
+    static constexpr uint64_t denseSize = 190080ULL * 224 * 504;
+    uint64_t denseIndex() const { return denseIndex(tracked); }
+    static uint64_t denseIndex(__int128 hash);
+    static uint64_t denseIndex(const std::array<uint8_t, 8> &tracked);
+};
+
+
+#endif //RUBIKSSOLVER_HASHEDCUBE_HPP
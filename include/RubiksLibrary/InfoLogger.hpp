@@ -6,10 +6,12 @@
 
 class InfoLogger {
 public:
-	InfoLogger();
+	// A disabled logger only counts, for generators that run several searches at once.
+	explicit InfoLogger(bool enabled = true);
 	void logg(const std::vector<char> &moves);
 	void incrementStates();
 private:
+	bool _enabled;
 	int _counter = 0;
 	std::chrono::system_clock::time_point _prevPrintTime;
 
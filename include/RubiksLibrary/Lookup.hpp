@@ -10,6 +10,10 @@
 #include <set>
 
 #include "RubiksLibrary/RubiksCube.hpp"
+#include "RubiksLibrary/MappedTable.hpp"
+#include "RubiksLibrary/FlatIndex.hpp"
+#include "RubiksLibrary/ParentMoveTable.hpp"
+#include "RubiksLibrary/PruningTable.hpp"
 
 struct Position {
     std::array<int, 10> currPos = {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
@@ -20,33 +24,87 @@ public:
     std::map<std::array<unsigned int, 4>, std::vector<char>> firstTwoLayers;
     std::map<std::array<unsigned int, 4>, std::vector<char>> crossAnd2Corners;
     std::set<std::array<unsigned int, 4>> crossAnd2CornersLookupOnly;
-    std::unordered_map<uint64_t, std::vector<char>> smallerUnorderedCrossAnd2Corners;
-    std::unordered_map<uint64_t, std::vector<char>> smallerUnorderedCrossAnd3Corners;
+    std::unordered_map<uint64_t, PackedMoves> smallerUnorderedCrossAnd2Corners;
+    std::unordered_map<uint64_t, PackedMoves> smallerUnorderedCrossAnd3Corners;
     std::map<std::array<unsigned int, 4>, std::vector<char>> crossAnd3Corners;
     std::map<std::array<unsigned int, 4>, std::vector<char>> solveLastLayer;
     std::map<std::array<unsigned int, 4>, std::vector<char>> solveTwoLayer;
     std::map<std::array<unsigned int, 4>, std::vector<char>> wholeCube;
     std::map<std::array<unsigned int, 4>, std::vector<char>> combined;
     std::map<std::array<unsigned int, 4>, std::vector<char>> solveFromCrossAnd2Corners;
-    std::unordered_map<__int128, std::vector<char>> newHashMap2Corner;
-    std::unordered_map<__int128, std::vector<char>> newHashMap3Corner;
+    std::unordered_map<__int128, PackedMoves> newHashMap2Corner;
+    std::unordered_map<__int128, PackedMoves> newHashMap3Corner;
+    std::unordered_map<uint64_t, PackedMoves> coordinateMap2Corner;
+
+    // Memory mapped versions of the two maps above, the solver uses these instead when they are open.
+    MappedTable<__int128> newHashTable2Corner;
+    MappedTable<uint64_t> coordinateTable2Corner;
+
+    // Memory mapped versions of crossAnd2Corners, solveTwoLayer and solveLastLayer, see loadAllMaps().
+    MappedSequenceTable crossAnd2CornersTable;
+    MappedSequenceTable solveTwoLayerTable;
+    MappedSequenceTable solveLastLayerTable;
+
+    // Compact read-only copies of the newHash maps, see buildIndexes().
+    FlatIndex<__int128> newHashIndex2Corner;
+    FlatIndex<__int128> newHashIndex3Corner;
+
+    // Last move only version of newHashMap2Corner, see buildParentTables().
+    ParentMoveTable newHashParents2Corner;
+
+    // Moves to solve the cross with the two corners, and the cross with the two slot edges, see
+    // makeDistanceTables2Corner(). The larger of the two never overestimates the cross + 2 corner stage.
+    PruningTable crossCornersDistance;
+    PruningTable crossSlotEdgesDistance;
 
     void makeFirstTwoLayers(int depth);
     void makeCrossAnd2Corners(int depth);
     void makeCrossAnd3Corners(int depth);
     void makeWholeCube(int depth);
-    void generateLookupNewHash2Corner(int depth);
+    // Builds newHashMap2Corner up to depth moves and saves it as newHashMap2CornersConstructedDepth<depth>.
+    // The 18 first moves are generated as separate shards on workers threads (0 is one per hardware thread)
+    // and merged in parallel, keeping the shortest sequence for every key.
+    // Every finished shard is checkpointed as newHashMap2CornersConstructedDepth<depth>Shard<first move>.
+    void generateLookupNewHash2Corner(int depth, unsigned workers = 0);
+    // Same as generateLookupNewHash2Corner, but loads the shards an interrupted run already finished.
+    void resumeLookupNewHash2Corner(int depth, unsigned workers = 0);
+    // Same table, written straight to DATA_PATH/newHashMap2CornersConstructedDepth<depth>.tbl through an
+    // ExternalTableBuilder, so no more than maxRecordsInMemory records are held at once.
+    static void generateLookupNewHash2CornerOnDisk(int depth, size_t maxRecordsInMemory);
+    void generateLookupCoordinate2Corner(int depth);
+    // Same table as generateLookupCoordinate2Corner, built one depth layer at a time. Every state is expanded
+    // once, so the stored sequences are shortest by construction and nothing is searched twice.
+    // The table is checkpointed after every layer as coordinateMap2CornerDepth<depth>Layers.
+    void generateLookupCoordinate2CornerBreadthFirst(int depth);
+    // Continues from the last layer an interrupted generateLookupCoordinate2CornerBreadthFirst checkpointed.
+    void resumeLookupCoordinate2CornerBreadthFirst(int depth);
+    // Loads coordinateMap2CornerDepth<fromDepth> and expands only its deepest layer until toDepth, so the
+    // cost is that of the new layers. Works for tables from either coordinate generator, both store every
+    // state with its shortest length.
+    void extendLookupCoordinate2Corner(int fromDepth, int toDepth);
+
+    // Loads or generates the two distance tables at 4 bits per state (about 50 MB each) or 2 bits.
+    void makeDistanceTables2Corner(int bitsPerState = 4);
+    // Lower bound on the moves to solve cross + 2 corners from coordinates, 0 without distance tables.
+    int distance2Corner(const CrossAnd2CornersCoordinates &coordinates) const;
+
+    // Builds the FlatIndex of each newHash map and frees the map, the solver then searches the index.
+    void buildIndexes();
+    // Builds newHashParents2Corner and frees newHashMap2Corner. Takes less memory than buildIndexes(), but
+    // every hit in the search has to walk the table to get its moves.
+    void buildParentTables();
 
     static bool prune(const Move &currentMove, const Move &prevMove, const Move &doublePrevMove);
 
-    static void save(std::unordered_map<__int128, std::vector<char>> &map, const std::string &title);
+    static void save(std::unordered_map<__int128, PackedMoves> &map, const std::string &title);
+    static void save(std::unordered_map<uint64_t, PackedMoves> &map, const std::string &title);
     static void save(std::set<std::array<unsigned int, 4>> &map, const std::string &title);
     static void save(std::map<std::array<unsigned int, 4>, uint32_t> &map, const std::string &title);
     static void save(std::map<std::pair<uint32_t, uint16_t>, uint32_t>& map, const std::string& title);
     static void save(std::map<std::array<unsigned int, 4>, std::vector<char>> &map, std::string &title);
 
-    static void load(std::unordered_map<uint64_t, std::vector<char>> &map, std::string &title);
-    static void load(std::unordered_map<__int128, std::vector<char>> &map, std::string &title);
+    static void load(std::unordered_map<uint64_t, PackedMoves> &map, std::string &title);
+    static void load(std::unordered_map<__int128, PackedMoves> &map, std::string &title);
     static void load(std::map<std::array<unsigned int, 4>, std::vector<char>> &map, std::string &title);
     static void load(std::set<std::array<unsigned int, 4>> &map, std::string &title);
 
@@ -55,10 +113,26 @@ public:
     static uint64_t getSize(std::map<uint64_t, std::vector<char>> &map);
     static uint64_t getSize(std::map<uint64_t, uint32_t> &map);
     static uint64_t getSize(std::map<std::pair<uint32_t, uint16_t>, uint32_t> &map);
+    // Maps the tables the full cube solver needs from DATA_PATH/<name>.seq. A table that only exists as the
+    // text file written by save() is parsed once and converted, later starts only map the files.
     static Lookup loadAllMaps();
+    // The depth the newHash 2 corner table the solver searches was generated to, its longest sequence. Found
+    // by reading the table the first time and kept; openNewHashTable2Corner() forgets it. 0 without a table.
+    int newHashDepth2Corner();
+    // Map DATA_PATH/title.tbl as newHashTable2Corner and coordinateTable2Corner.
+    void openNewHashTable2Corner(const std::string &title);
+    void openCoordinateTable2Corner(const std::string &title);
 
+    // Converts a newHash table written by save() (DATA_PATH/title.txt) into a MappedTable (DATA_PATH/title.tbl).
+    static void convertToMappedTable(const std::string &title);
+    // Merges newHash tables written by save() into one MappedTable (DATA_PATH/title.tbl) without loading
+    // them, keeping the shortest sequence per key and the earlier table on a tie, like combineLookups.
+    static void combineOnDisk(const std::vector<std::string> &titles, const std::string &title, size_t maxRecordsInMemory);
     static void convertAndSave(std::map<std::array<unsigned int, 4>, std::vector<char>> &map, std::string &title);
     static uint64_t hashF(const std::array<unsigned int, 4> &num, uint32_t seed = 321464301);
+
+private:
+    int newHashDepth2CornerCache = -1;
 };
 
 
@@ -0,0 +1,115 @@
+
+#ifndef RUBIKSSOLVER_MAPPEDTABLE_HPP
+#define RUBIKSSOLVER_MAPPEDTABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "RubiksLibrary/Move.hpp"
+
+namespace MappedTableConst {
+    constexpr char magic[8] = {'R', 'U', 'B', 'I', 'K', 'T', 'B', 'L'};
+    // Version 2 stores PackedMoves values, version 1 had a length byte followed by move characters.
+    constexpr uint32_t version = 2;
+
+    // MappedSequenceTable files share the header, valueBytes is 0 for their variable length values.
+    constexpr char sequenceMagic[8] = {'R', 'U', 'B', 'I', 'K', 'S', 'E', 'Q'};
+    constexpr uint32_t sequenceVersion = 1;
+
+    // Start of every table file, followed by the keys and then the values at the given offsets.
+    // All numbers are stored little-endian, the way x86 and ARM hold them in memory.
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t keyBytes;
+        uint64_t count;
+        uint32_t valueBytes;
+        uint32_t reserved;
+        uint64_t keysOffset;
+        uint64_t valuesOffset;
+    };
+}
+
+// A read-only lookup table stored as DATA_PATH/title.tbl: the keys sorted in one fixed-width array and
+// the move sequences in a parallel array of PackedMoves.
+// The file is memory mapped and searched in place, so opening it costs nothing regardless of its size.
+template<typename Key>
+class MappedTable {
+public:
+    MappedTable() = default;
+    explicit MappedTable(const std::string &title);
+    ~MappedTable();
+
+    MappedTable(const MappedTable &) = delete;
+    MappedTable &operator=(const MappedTable &) = delete;
+    MappedTable(MappedTable &&other) noexcept;
+    MappedTable &operator=(MappedTable &&other) noexcept;
+
+    static void write(const std::unordered_map<Key, PackedMoves> &map, const std::string &title);
+
+    bool isOpen() const { return data != nullptr; }
+    size_t size() const { return count; }
+    // The longest stored sequence, the depth the table was generated to. Reads every value.
+    size_t maxLength() const;
+
+    bool contains(Key key) const;
+    std::optional<PackedMoves> find(Key key) const;
+
+private:
+    void close();
+
+    const unsigned char *data = nullptr;
+    size_t fileSize = 0;
+
+    const Key *keys = nullptr;
+    const PackedMoves *values = nullptr;
+    size_t count = 0;
+};
+
+// The array-keyed tables of Lookup::loadAllMaps (cross + 2 corners, two layer, last layer) stored as
+// DATA_PATH/title.seq. Their sequences are longer than a PackedMoves holds, so the values are runs of move
+// characters: the keys sorted in one array, then count + 1 offsets into the move characters.
+// Memory mapped like MappedTable, so opening it takes no parsing.
+class MappedSequenceTable {
+public:
+    using Key = std::array<unsigned int, 4>;
+
+    MappedSequenceTable() = default;
+    explicit MappedSequenceTable(const std::string &title);
+    ~MappedSequenceTable();
+
+    MappedSequenceTable(const MappedSequenceTable &) = delete;
+    MappedSequenceTable &operator=(const MappedSequenceTable &) = delete;
+    MappedSequenceTable(MappedSequenceTable &&other) noexcept;
+    MappedSequenceTable &operator=(MappedSequenceTable &&other) noexcept;
+
+    static void write(const std::map<Key, std::vector<char>> &map, const std::string &title);
+    static bool exists(const std::string &title);
+
+    bool isOpen() const { return data != nullptr; }
+    size_t size() const { return count; }
+
+    // The moves stored for key, pointing into the mapped file.
+    std::optional<std::string_view> find(const Key &key) const;
+
+private:
+    void close();
+
+    const unsigned char *data = nullptr;
+    size_t fileSize = 0;
+
+    const Key *keys = nullptr;
+    const uint64_t *offsets = nullptr;
+    const char *moves = nullptr;
+    size_t count = 0;
+};
+
+
+#endif //RUBIKSSOLVER_MAPPEDTABLE_HPP
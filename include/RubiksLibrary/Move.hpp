@@ -1,10 +1,15 @@
 
+#include <array>
+#include <cstdint>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #ifndef RUBIKSSOLVER_MOVE_HPP
 #define RUBIKSSOLVER_MOVE_HPP
 
+class PackedMoves;
+
 class Move {
 public:
     explicit Move(char m);
@@ -29,11 +34,72 @@ public:
 
     static std::vector<char> convertVectorMoveToChar(const std::vector<Move> &moves);
     static std::vector<Move> convertVectorCharToMove(const std::vector<char> &moves);
+    static std::vector<Move> convertVectorCharToMove(const PackedMoves &moves);
 
     static void printMoves(std::vector<Move> &moves);
     static void printMoves(const std::vector<char> &moves, const std::string& end = "\n");
 };
 
+// A decoded PackedMoves, iterable like the std::vector<char> it replaces but without a heap allocation.
+struct MoveBuffer {
+    std::array<char, 12> moves{};
+    uint8_t length = 0;
+
+    const char *begin() const { return moves.data(); }
+    const char *end() const { return moves.data() + length; }
+    size_t size() const { return length; }
+};
+
+// A move sequence of up to 30 moves stored in place, one char per move, for search paths where a
+// std::vector<Move> would allocate at every node.
+struct MoveStack {
+    static constexpr size_t capacity = 30;
+
+    std::array<char, capacity> moves{};
+    uint8_t length = 0;
+
+    void push_back(const char move) {
+        if (length == capacity) {
+            throw std::runtime_error("MoveStack holds at most 30 moves.");
+        }
+        moves[length++] = move;
+    }
+    void pop_back() { length--; }
+
+    char back() const { return moves[length - 1]; }
+    char operator[](const size_t i) const { return moves[i]; }
+    const char *begin() const { return moves.data(); }
+    const char *end() const { return moves.data() + length; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    // Appends the lookup moves undone, last first, like combineMovesWithLookupMoves.
+    void appendInverse(const PackedMoves &lookupMoves);
+    // Neighbouring turns of a face merged, like combineMoves.
+    MoveStack combined() const;
+    std::vector<Move> toMoves() const;
+};
+
+// A table value of up to 12 moves in one 64-bit word: the length in the low 4 bits, then 5 bits per move
+// (move - 'A'), first move lowest.
+class PackedMoves {
+public:
+    uint64_t bits = 0;
+
+    PackedMoves() = default;
+    // Implicit, so tables can keep being filled from the std::vector<char> move stacks.
+    PackedMoves(const std::vector<char> &moves);
+
+    size_t size() const { return bits & 0xF; }
+    void push_back(char move);
+    char operator[](const size_t i) const { return static_cast<char>('A' + ((bits >> (4 + 5 * i)) & 0x1F)); }
+
+    MoveBuffer unpack() const;
+    std::vector<char> toVector() const;
+
+    bool operator==(const PackedMoves &other) const = default;
+};
+
 namespace MoveConst {
     const Move illegalMove{7, 7};
 
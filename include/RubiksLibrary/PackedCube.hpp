@@ -0,0 +1,69 @@
+
+#ifndef RUBIKSSOLVER_PACKEDCUBE_HPP
+#define RUBIKSSOLVER_PACKEDCUBE_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "RubiksLibrary/Move.hpp"
+#include "RubiksLibrary/RubiksCube.hpp"
+
+namespace PackedConst {
+    using LaneMasks = std::array<std::array<uint8_t, 64>, 3>;
+
+    // masks[lane][i] is the byte pshufb must pick from 16-byte source lane `lane` to build byte i of
+    // the gather out[i] = in[source[i]], or 0x80 (write zero) when source[i] lies in another lane.
+    // OR-ing the three shuffled lanes gives the gathered cube. Bytes 48-63 are padding and stay zero.
+    constexpr LaneMasks makeLaneMasks(const std::array<unsigned char, 48> &source) {
+        LaneMasks masks{};
+
+        for (int lane = 0; lane < 3; lane++) {
+            for (int i = 0; i < 64; i++) {
+                masks[lane][i] = 0x80;
+
+                if (i >= 48) { continue; }
+
+                if (source[i] / 16 == lane) {
+                    masks[lane][i] = static_cast<uint8_t>(source[i] % 16);
+                }
+            }
+        }
+
+        return masks;
+    }
+
+    constexpr std::array<LaneMasks, 18> makeShuffleMasks() {
+        std::array<LaneMasks, 18> masks{};
+        for (int m = 0; m < 18; m++) {
+            masks[m] = makeLaneMasks(RubiksConst::movePermutations[m]);
+        }
+
+        return masks;
+    }
+
+    // One set of lane masks per entry in RubiksConst::everyMove.
+    alignas(64) constexpr std::array<LaneMasks, 18> shuffleMasks = makeShuffleMasks();
+}
+
+// The 48 facelets as one byte each, padded to a single 64-byte cache line.
+class alignas(64) PackedCube {
+public:
+    alignas(64) std::array<uint8_t, 64> facelets{};
+
+    PackedCube();
+    explicit PackedCube(const std::array<short, 48> &cube);
+    explicit PackedCube(const RubiksCube &cube);
+
+    std::array<short, 48> toArray() const;
+
+    void turn(Move m);
+    void turnIndex(int moveIndex);
+
+    bool solved() const;
+    bool operator==(const PackedCube &other) const;
+
+    __int128 hashNew2Corner() const;
+};
+
+
+#endif //RUBIKSSOLVER_PACKEDCUBE_HPP
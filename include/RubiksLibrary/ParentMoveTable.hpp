@@ -0,0 +1,116 @@
+#ifndef RUBIKSSOLVER_PARENTMOVETABLE_HPP
+#define RUBIKSSOLVER_PARENTMOVETABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "RubiksLibrary/Move.hpp"
+
+namespace ParentMoveConst {
+    constexpr uint8_t root = 0x1F;
+    constexpr int movesPerWord = 12;
+    // Low bits of an index stored per state, the bits above pick the bucket.
+    constexpr int suffixBits = 16;
+
+    constexpr int inverseMoveIndex(const int moveIndex) {
+        return moveIndex - moveIndex % 3 + 2 - moveIndex % 3;
+    }
+}
+
+// A lookup table that keeps only the last move of each stored sequence, 5 bits per state. The full
+// sequence is rebuilt by undoing that move and probing again until the solved state is reached, which
+// only has to happen for the states the search actually hits.
+//
+// States are stored by a gap-free index instead of their key. The indexes are sorted and split into
+// buckets on their high bits: a bucket start per 2^16 indexes, and the low 16 bits per state.
+// Keys with the same index (the untracked field 0 of hashNew2Corner) share one state, which gets the parent
+// of the shortest sequence among them. The rebuilt sequence is then never longer than the one in the map.
+class ParentMoveTable {
+public:
+    ParentMoveTable() = default;
+    // index maps every key of map into [0, indexCount).
+    template<typename Key, typename Index>
+    ParentMoveTable(const std::unordered_map<Key, PackedMoves> &map, uint64_t indexCount, Index index);
+
+    size_t size() const { return suffixes.size(); }
+    bool empty() const { return suffixes.empty(); }
+    // The longest sequence the table was built from.
+    size_t maxLength() const { return longest; }
+    size_t memoryUsage() const {
+        return bucketStarts.size() * sizeof(uint32_t) + suffixes.size() * sizeof(uint16_t) + parents.size() * sizeof(uint64_t);
+    }
+
+    bool contains(uint64_t index) const { return position(index) != suffixes.size(); }
+
+    // undo(moveIndex) applies moveIndex to the cube being walked and returns its new index. Gives up when the
+    // walk leaves the table or runs past what a PackedMoves holds.
+    template<typename Undo>
+    std::optional<PackedMoves> reconstruct(uint64_t index, Undo undo) const;
+
+private:
+    struct Entry {
+        uint64_t index;
+        uint8_t length;
+        uint8_t parent;
+    };
+
+    std::vector<uint32_t> bucketStarts;
+    std::vector<uint16_t> suffixes;
+    std::vector<uint64_t> parents;
+    size_t longest = 0;
+
+    void build(std::vector<Entry> &entries, uint64_t indexCount);
+
+    // Where index is stored, size() when it isn't.
+    size_t position(uint64_t index) const;
+
+    uint8_t parentAt(size_t i) const {
+        const auto shift = 5 * (i % ParentMoveConst::movesPerWord);
+        return static_cast<uint8_t>((parents[i / ParentMoveConst::movesPerWord] >> shift) & 0x1F);
+    }
+};
+
+template<typename Key, typename Index>
+ParentMoveTable::ParentMoveTable(const std::unordered_map<Key, PackedMoves> &map, const uint64_t indexCount, Index index) {
+    std::vector<Entry> entries;
+    entries.reserve(map.size());
+    for (const auto &[key, moves] : map) {
+        const uint8_t parent = moves.size() == 0 ? ParentMoveConst::root : moves[moves.size() - 1] - 'A';
+        entries.push_back({index(key), static_cast<uint8_t>(moves.size()), parent});
+        longest = std::max(longest, moves.size());
+    }
+    build(entries, indexCount);
+}
+
+template<typename Undo>
+std::optional<PackedMoves> ParentMoveTable::reconstruct(uint64_t index, Undo undo) const {
+    std::array<char, 12> moves{};
+    size_t length = 0;
+
+    while (true) {
+        const size_t i = position(index);
+        if (i == suffixes.size()) { return std::nullopt; }
+
+        const uint8_t parent = parentAt(i);
+        if (parent == ParentMoveConst::root) { break; }
+        if (length == moves.size()) { return std::nullopt; }
+
+        moves[length++] = static_cast<char>('A' + parent);
+        index = undo(ParentMoveConst::inverseMoveIndex(parent));
+    }
+
+    // Collected from the state back to solved, the table stores solved to the state.
+    PackedMoves out;
+    while (length > 0) {
+        out.push_back(moves[--length]);
+    }
+    return out;
+}
+
+
+#endif //RUBIKSSOLVER_PARENTMOVETABLE_HPP
@@ -0,0 +1,70 @@
+
+#ifndef RUBIKSSOLVER_PRUNINGTABLE_HPP
+#define RUBIKSSOLVER_PRUNINGTABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RubiksLibrary/Coordinate.hpp"
+
+// The number of moves to solved for every state of a product of coordinates, without the moves themselves.
+// State ((c0 * size1 + c1) * size2 + c2)... is the coordinates c0, c1, c2, ... turned by their move tables,
+// which have to outlive the table.
+// With 4 bits per state the distance is stored as is (up to 14). With 2 bits only the distance mod 3 is
+// stored, a neighbour's distance is one of d - 1, d, d + 1 so it follows from the state being searched.
+// The distance counts moves from moveIndices, all 18 when empty; the set has to contain every inverse.
+class PruningTable {
+public:
+    PruningTable() = default;
+
+    // Breadth-first from solved, one flat pass over the table per depth.
+    static PruningTable generate(std::vector<const CoordinateMoveTable *> tables, std::vector<uint64_t> sizes,
+                                 uint64_t solved, int bitsPerState, std::vector<int> moveIndices = {});
+
+    // Reads DATA_PATH/title.bin, or generates the table and writes it there on the first run.
+    static PruningTable loadOrGenerate(std::vector<const CoordinateMoveTable *> tables, std::vector<uint64_t> sizes,
+                                       uint64_t solved, int bitsPerState, const std::string &title,
+                                       std::vector<int> moveIndices = {});
+
+    void save(const std::string &title) const;
+
+    uint64_t turn(uint64_t state, int moveIndex) const;
+
+    // Moves to solved. With 2 bits per state this walks to solved, so searches should use the overload below.
+    int distance(uint64_t state) const;
+    // Moves to solved for a neighbour of a state neighbourDistance moves from solved.
+    int distance(uint64_t state, int neighbourDistance) const;
+
+    bool isOpen() const { return !data.empty(); }
+    uint64_t size() const { return numStates; }
+    int bitsPerState() const { return bits; }
+    size_t memoryUsage() const { return data.size(); }
+
+    static constexpr int unreached = -1;
+
+private:
+    std::vector<const CoordinateMoveTable *> tables;
+    std::vector<uint64_t> sizes;
+    std::vector<int> moveIndices;
+    uint64_t solved = 0;
+    uint64_t numStates = 0;
+    int bits = 4;
+
+    std::vector<uint8_t> data;
+
+    // Only succeeds for a file with the same size and bits per state.
+    bool load(const std::string &title);
+
+    void setUp(std::vector<const CoordinateMoveTable *> tables, std::vector<uint64_t> sizes, uint64_t solved,
+               int bitsPerState, std::vector<int> moveIndices);
+
+    uint8_t get(uint64_t state) const {
+        const int shift = static_cast<int>(state % (8 / bits)) * bits;
+        return (data[state * bits / 8] >> shift) & ((1 << bits) - 1);
+    }
+    void set(uint64_t state, uint8_t value);
+};
+
+
+#endif //RUBIKSSOLVER_PRUNINGTABLE_HPP
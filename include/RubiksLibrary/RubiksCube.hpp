@@ -17,11 +17,84 @@ enum Hash {
     TwoCornerNewHash
 };
 
+enum TurnEngine {
+    HandWritten,
+    PermutationTable
+};
+
 namespace RubiksConst {
     std::array<Move, 18> extern everyMove;
 
     constexpr std::array<int, 3> oppositeFace = {5, 4, 3};
     constexpr std::array<int, 6> oppositeFaceAll = {5, 4, 3, 2, 1, 0};
+    // Facelet cycles of a quarter turn (rotations == 1) for every face, in Move::face order.
+    // A cycle {a, b, c, d} moves the sticker at b to a, c to b, d to c and a to d.
+    constexpr std::array<std::array<std::array<int, 4>, 5>, 6> quarterTurnCycles = {{
+        {{{ 0,  5,  7,  2}, { 1,  3,  6,  4}, {10, 16, 37, 47}, {12, 17, 35, 46}, {15, 18, 32, 45}}}, // White
+        {{{ 0, 40, 24, 16}, { 3, 43, 27, 19}, { 5, 45, 29, 21}, { 8, 13, 15, 10}, { 9, 11, 14, 12}}}, // Red
+        {{{ 5, 13, 26, 37}, { 6, 14, 25, 38}, { 7, 15, 24, 39}, {16, 21, 23, 18}, {17, 19, 22, 20}}}, // Blue
+        {{{ 0, 32, 31,  8}, { 1, 33, 30,  9}, { 2, 34, 29, 10}, {40, 45, 47, 42}, {41, 43, 46, 44}}}, // Green
+        {{{ 2, 18, 26, 42}, { 4, 20, 28, 44}, { 7, 23, 31, 47}, {32, 37, 39, 34}, {33, 35, 38, 36}}}, // Orange
+        {{{ 8, 42, 39, 21}, {11, 41, 36, 22}, {13, 40, 34, 23}, {24, 29, 31, 26}, {25, 27, 30, 28}}}  // Yellow
+    }};
+
+    // movePermutations[m][i] is the facelet whose sticker ends up at i after move m ('A' + m).
+    constexpr std::array<std::array<unsigned char, 48>, 18> makeMovePermutations() {
+        std::array<std::array<unsigned char, 48>, 18> permutations{};
+
+        for (int face = 0; face < 6; face++) {
+            std::array<unsigned char, 48> quarter{};
+            for (int i = 0; i < 48; i++) {
+                quarter[i] = static_cast<unsigned char>(i);
+            }
+            for (const auto &cycle : quarterTurnCycles[face]) {
+                for (int k = 0; k < 4; k++) {
+                    quarter[cycle[k]] = static_cast<unsigned char>(cycle[(k + 1) % 4]);
+                }
+            }
+
+            std::array<unsigned char, 48> current = quarter;
+            for (int rotations = 0; rotations < 3; rotations++) {
+                permutations[face * 3 + rotations] = current;
+
+                std::array<unsigned char, 48> next{};
+                for (int i = 0; i < 48; i++) {
+                    next[i] = current[quarter[i]];
+                }
+                current = next;
+            }
+        }
+
+        return permutations;
+    }
+
+    constexpr std::array<std::array<unsigned char, 48>, 18> movePermutations = makeMovePermutations();
+
+    // The 20 facelets a move actually changes, as (destination, source) pairs taken from movePermutations.
+    struct MovedFacelets {
+        std::array<unsigned char, 20> destination;
+        std::array<unsigned char, 20> source;
+    };
+
+    constexpr std::array<MovedFacelets, 18> makeMovedFacelets() {
+        std::array<MovedFacelets, 18> moved{};
+
+        for (int m = 0; m < 18; m++) {
+            int k = 0;
+            for (int i = 0; i < 48; i++) {
+                if (movePermutations[m][i] == i) { continue; }
+
+                moved[m].destination[k] = static_cast<unsigned char>(i);
+                moved[m].source[k] = movePermutations[m][i];
+                k++;
+            }
+        }
+
+        return moved;
+    }
+
+    constexpr std::array<MovedFacelets, 18> movedFacelets = makeMovedFacelets();
+
     const std::array<short, 48> solvedCube = {0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2,5,5,5,5,5,5,5,5,4,4,4,4,4,4,4,4,3,3,3,3,3,3,3,3};
 
     const std::array<std::vector<int>, 48> physicalPieces = {{
@@ -220,9 +293,12 @@ public:
     //                                               10                  20                  30                  40
     //                            0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7
     std::array<short, 48> cube = {0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2,5,5,5,5,5,5,5,5,4,4,4,4,4,4,4,4,3,3,3,3,3,3,3,3};
+    static TurnEngine turnEngine;
+
     void turn(int face, int rotations);
     void turn(char m);
     void turn(Move m);
+    void turnIndex(int moveIndex);
 
     static std::array<short, 48> getCubeFromHash(__int128 hash);
     __int128 hashNewV0() const;
@@ -263,6 +339,8 @@ private:
     bool solvedOGCorner();
     bool solvedBOCorner();
 
+    void turnHandWritten(char m);
+
     void turnWhite(int rotations);
     void turnWhite1();
     void turnWhite2();
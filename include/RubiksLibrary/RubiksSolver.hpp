@@ -2,27 +2,36 @@
 #ifndef RUBIKSSOLVER_HPP
 #define RUBIKSSOLVER_HPP
 
+#include <string>
 #include <vector>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include "RubiksLibrary/Lookup.hpp"
+#include "RubiksLibrary/Solver.hpp"
 
 class RubiksSolver {
 public:
 	RubiksSolver();
 	~RubiksSolver();
 
-	std::vector<char> solve(const std::vector<int> &input);
+	// engine is "lookup" for Solver::solveFullCube or "twoPhase" for TwoPhaseSolver. A positive timeLimitMs
+	// makes either engine return the best solution it has after that many milliseconds, and an empty one when
+	// it has none yet. workers is the number of threads the lookup engine searches with.
+	std::vector<char> solve(const std::vector<int> &input, const std::string &engine = "lookup", int timeLimitMs = 0,
+	                        unsigned workers = 1);
 
 private:
 	Lookup lookup;
+	// Kept between calls, so a multi-threaded solve reuses its threads.
+	Solver solver;
 };
 
 PYBIND11_MODULE(RubiksSolver, m) {
 	pybind11::class_<RubiksSolver>(m, "RubiksSolver")
 		.def(pybind11::init<>())
-		.def("solve", &RubiksSolver::solve);
+		.def("solve", &RubiksSolver::solve, pybind11::arg("input"), pybind11::arg("engine") = "lookup",
+		     pybind11::arg("timeLimitMs") = 0, pybind11::arg("workers") = 1);
 }
 
 
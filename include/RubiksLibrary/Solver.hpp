@@ -2,47 +2,157 @@
 #ifndef SOLVER_HPP
 #define SOLVER_HPP
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
 
 #include "RubiksLibrary/Move.hpp"
 #include "RubiksLibrary/Lookup.hpp"
 #include "RubiksLibrary/solution.hpp"
 #include "RubiksLibrary/RubiksCube.hpp"
+#include "RubiksLibrary/HashedCube.hpp"
+#include "RubiksLibrary/Coordinate.hpp"
+#include "RubiksLibrary/WorkStealing.hpp"
 
+// Table is Lookup::crossAnd2Corners or its MappedSequenceTable.
+template<typename Table>
 struct SearchConditions {
 	RubiksCube &cube;
-	std::map<std::array<unsigned int, 4>, std::vector<char>> &lookup;
+	const Table &lookup;
 	std::vector<Move> &moves;
 	std::vector<Solution> &solutions;
 	Hash hash;
 };
 
+// Table is the unordered_map from Lookup, its MappedTable, its FlatIndex or its ParentMoveTable.
+template<typename Table>
 struct SearchConditionsNewHash {
-	RubiksCube &cube;
-	std::unordered_map<__int128, std::vector<char>> &lookup;
+	HashedCube &cube;
+	const Table &lookup;
 	std::vector<Move> &moves;
 	std::vector<Solution> &solutions;
 	Hash hash;
 };
 
+// The allocation-free newHash search: the move stack and the solutions are MoveStacks, and the solutions go
+// into a SearchArena.
+template<typename Table>
+struct SearchConditionsStack {
+	HashedCube &cube;
+	const Table &lookup;
+	MoveStack &moves;
+	std::vector<MoveStack> &solutions;
+};
+
+// Candidate solutions of the allocation-free searches. It is cleared, not freed, between solves, so once it has
+// grown to the largest solve a search doesn't allocate at all.
+struct SearchArena {
+	std::vector<MoveStack> solutions;
+};
+
+template<typename Table>
+struct SearchConditionsCoordinates {
+	const std::array<CoordinateMoveTable, 3> &moveTables;
+	const Table &lookup;
+	std::vector<Move> &moves;
+	std::vector<Solution> &solutions;
+};
+
+// The cross + 2 corner state is turned on its coordinates and bounded by Lookup's distance tables. The
+// distances ride along with the coordinates, which 2 bit tables need to decode a neighbour.
+struct SearchConditionsIDAStar {
+	const std::array<CoordinateMoveTable, 3> &moveTables;
+	const PruningTable &crossCorners;
+	const PruningTable &crossSlotEdges;
+	std::vector<Move> &moves;
+	std::vector<Solution> &solutions;
+	uint64_t nodes = 0;
+};
+
 struct SearchConditionsUnordered {
 	RubiksCube &cube;
-	std::unordered_map<uint64_t, std::vector<char>> &lookup;
+	std::unordered_map<uint64_t, PackedMoves> &lookup;
 	std::vector<Move> &moves;
 	std::vector<Solution> &solutions;
 	Hash hash;
 };
 
+// How the cross/corner searches use threads. With more than one worker the move tree is split into subtrees
+// on a WorkStealingExecutor, no deeper than splitDepth moves below the root, and each worker searches whole
+// subtrees with its own cube and move stack. The solutions come back in the same order as from the serial
+// search.
+struct ParallelSearch {
+	unsigned workers = 1;
+	int splitDepth = 2;
+};
+
+// What solveFullCube returns. best finishes every cross/corner solution of the first depth with a hit and
+// returns the shortest; firstHit returns the first one finished, and stops every search task at the first hit;
+// anytime finishes the shortest starts first, so the deadline cuts off the least promising ones.
+enum class SolveMode {best, firstHit, anytime};
+
+struct SolveOptions {
+	SolveMode mode = SolveMode::best;
+	ParallelSearch parallel;
+	// A hard limit in every mode: the searches stop when it passes, and the result is empty if the cross stage
+	// had no solution by then. Finishing stops at it too, after at least one solution.
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	// Called with every solution shorter than the ones before it.
+	std::function<void(const std::vector<Move> &)> onImprovement;
+	// With twoCorner, search the cross and two corners with findCrossAnd2CornersInArena on the newHash table in
+	// lookup. That search is single threaded and only checks the deadline between depths.
+	bool arena = false;
+};
+
 class Solver {
 public:
 	// TODO: refactor most of solving code
 	std::vector<Move> solveFullCube(RubiksCube &cube, Lookup &lookup, int depth = 4, bool twoCorner = true);
+	std::vector<Move> solveFullCube(RubiksCube &cube, Lookup &lookup, const SolveOptions &options, int depth = 4, bool twoCorner = true);
 	std::vector<Move> solveFullCubeUsingUnordered(RubiksCube &cube, Lookup &lookup, int depth = 4);
 
 	std::vector<Move> solveUpTo3Corners(RubiksCube &cube, Lookup &lookup, int depth = 4);
-	static std::vector<Move> solveUpTo2CornersUsingNewHash(RubiksCube &cube, Lookup &lookup, int depth = 4);
-	static std::vector<Solution> findCrossAnd2CornersUsingNewHash(RubiksCube &cube, Lookup &lookup, int depth = 3);
-	static void searchMovesNewHash(SearchConditionsNewHash &searchConditions, int depth);
+	// The find functions deepen one move at a time from depth until a lookup hits. With leavesOnly a search
+	// probes only the nodes depth moves below, the ones the previous depth didn't reach.
+	static std::vector<Move> solveUpTo2CornersUsingNewHash(RubiksCube &cube, Lookup &lookup, int depth = 4, const ParallelSearch &parallel = {});
+	static std::vector<Solution> findCrossAnd2CornersUsingNewHash(RubiksCube &cube, Lookup &lookup, int depth = 3, const ParallelSearch &parallel = {});
+	template<typename Table>
+	static void searchMovesNewHash(SearchConditionsNewHash<Table> &searchConditions, int depth, bool leavesOnly = false);
+
+	// Meet in the middle against a newHash table holding every state up to Lookup::newHashDepth2Corner() moves
+	// from solved. Only the nodes exactly forwardDepth moves from the scramble are probed, with the children of
+	// a node looked up as one batch, and forwardDepth grows until a probe hits. It starts at the distance
+	// tables' lower bound minus the table depth when those are open, else at 0.
+	static std::vector<Move> solveUpTo2CornersMeetInTheMiddle(RubiksCube &cube, Lookup &lookup, int maxDepth = 20,
+	                                                          const ParallelSearch &parallel = {});
+	static std::vector<Solution> findCrossAnd2CornersMeetInTheMiddle(RubiksCube &cube, Lookup &lookup, int maxDepth = 20,
+	                                                                 const ParallelSearch &parallel = {});
+	template<typename Table>
+	static void searchMovesMeetInTheMiddle(SearchConditionsNewHash<Table> &searchConditions, int forwardDepth);
+
+	// Same search as solveUpTo2CornersUsingNewHash without heap allocations after warmup, single threaded.
+	// The candidates are left in arena.solutions.
+	static MoveStack solveUpTo2CornersInArena(RubiksCube &cube, const Lookup &lookup, SearchArena &arena, int depth = 4);
+	static void findCrossAnd2CornersInArena(RubiksCube &cube, const Lookup &lookup, SearchArena &arena, int depth = 3,
+	                                        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+	template<typename Table>
+	static void searchMovesStack(SearchConditionsStack<Table> &searchConditions, int depth, bool leavesOnly = false);
+
+	// Same search on coordinates, using Lookup::coordinateMap2Corner.
+	static std::vector<Move> solveUpTo2CornersUsingCoordinates(RubiksCube &cube, Lookup &lookup, int depth = 4);
+	static std::vector<Solution> findCrossAnd2CornersUsingCoordinates(RubiksCube &cube, Lookup &lookup, int depth = 3);
+	template<typename Table>
+	static void searchMovesCoordinates(SearchConditionsCoordinates<Table> &searchConditions, CrossAnd2CornersCoordinates coordinates, int depth, bool leavesOnly = false);
+
+	// IDA* on coordinates, no move table needed: Lookup::makeDistanceTables2Corner() is called if the distance
+	// tables aren't open, and the bound grows from the root's lower bound until the stage is solved. Returns
+	// every solution of the first bound that has one, so all of them are optimal.
+	static std::vector<Move> solveUpTo2CornersUsingIDAStar(RubiksCube &cube, Lookup &lookup, int maxDepth = 20);
+	static std::vector<Solution> findCrossAnd2CornersUsingIDAStar(RubiksCube &cube, Lookup &lookup, int maxDepth = 20);
+	static void searchMovesIDAStar(SearchConditionsIDAStar &searchConditions, CrossAnd2CornersCoordinates coordinates,
+	                               int cornersDistance, int slotEdgesDistance, int depth);
 
 private:
 	std::vector<Solution> findCrossAnd2Corners(RubiksCube &cube, Lookup &lookup, int depth = 3);
@@ -50,8 +160,25 @@ private:
 	std::vector<Solution> findCrossAnd3Corners(RubiksCube &cube, Lookup &lookup, int depth = 3);
 	void findAndTestSolutionsFirstTwoLayers(std::array<short, 48> &shuffled, Lookup &lookup, std::vector<Solution> &solutions);
 	void findAndTestSolutionsLastLayer(std::array<short, 48> &shuffled, Lookup &lookup, std::vector<Solution> &solutions);
-	void searchMoves(SearchConditions &searchConditions, int depth);
-	void searchMovesUnordered(SearchConditionsUnordered &searchConditions, int depth);
+	template<typename Table>
+	void searchMoves(SearchConditions<Table> &searchConditions, int depth, bool leavesOnly = false);
+	void searchMovesUnordered(SearchConditionsUnordered &searchConditions, int depth, bool leavesOnly = false);
+
+	// Set by solveFullCube for searchMoves and searchMovesUnordered.
+	SolveMode searchMode = SolveMode::best;
+	ParallelSearch searchParallel;
+	std::chrono::steady_clock::time_point searchDeadline = std::chrono::steady_clock::time_point::max();
+	// Set from every search task, by the first hit in firstHit mode or once the deadline has passed.
+	std::atomic<bool> searchStopped = false;
+	bool stopSearch(int depth);
+	void foundSolution();
+
+	// The threads of searchParallel, reused by every solve on this Solver.
+	std::unique_ptr<WorkStealingExecutor> executor;
+	WorkStealingExecutor *searchExecutor();
+
+	// The candidates of SolveOptions::arena, kept between solves like the executor.
+	SearchArena searchArena;
 };
 
 
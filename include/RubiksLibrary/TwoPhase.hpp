@@ -0,0 +1,78 @@
+
+#ifndef RUBIKSSOLVER_TWOPHASE_HPP
+#define RUBIKSSOLVER_TWOPHASE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "RubiksLibrary/Move.hpp"
+#include "RubiksLibrary/RubiksCube.hpp"
+#include "RubiksLibrary/CubieCube.hpp"
+#include "RubiksLibrary/Coordinate.hpp"
+#include "RubiksLibrary/PruningTable.hpp"
+
+namespace TwoPhaseConst {
+    // The middle layer edges, the slice that stays put in phase 2.
+    constexpr std::array<int, 4> sliceEdges = {4, 5, 6, 7};
+    constexpr std::array<int, 8> layerEdges = {0, 1, 2, 3, 8, 9, 10, 11};
+
+    constexpr uint32_t numTwists = 2187;        // 3^7
+    constexpr uint32_t numFlips = 2048;         // 2^11
+    constexpr uint32_t numSlices = 495;         // 12 choose 4
+    constexpr uint32_t numCornerPermutations = 40320; // 8!
+    constexpr uint32_t numLayerEdgePermutations = 40320;
+    constexpr uint32_t numSlicePermutations = 24;
+
+    constexpr int maxPhase1Length = 12;
+    constexpr int maxPhase2Length = 18;
+}
+
+// Coordinates of the two-phase solver. Phase 1 brings the cube into the group generated by the white and
+// yellow faces and half turns of the others: every corner and edge oriented, the slice edges in the slice.
+// Phase 2 solves the permutation with those moves only.
+struct TwoPhaseCoordinates {
+    static uint32_t twist(const CubieCube &cube);
+    static uint32_t flip(const CubieCube &cube);
+    static uint32_t slice(const CubieCube &cube);
+
+    // Only valid inside the phase 2 group.
+    static uint32_t cornerPermutation(const CubieCube &cube);
+    static uint32_t layerEdgePermutation(const CubieCube &cube);
+    static uint32_t slicePermutation(const CubieCube &cube);
+};
+
+// A Kociemba style two-phase solver on CubieCube. Every phase 1 solution (shortest first) is completed with
+// the shortest phase 2, until the total is at most targetLength. The move and pruning tables take a few MB
+// and are read from DATA_PATH, or generated there on first use.
+class TwoPhaseSolver {
+public:
+    // The shortest solution found, stopping as soon as one has at most targetLength moves. 21 takes tens of
+    // milliseconds, 20 a few times longer. The search also stops at deadline, with the best solution it has
+    // by then, or an empty one.
+    static std::vector<Move> solve(const RubiksCube &cube, int targetLength = 21,
+                                   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+    static std::vector<Move> solve(const CubieCube &cube, int targetLength = 21,
+                                   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    struct Tables {
+        CoordinateMoveTable twist, flip, slice;
+        CoordinateMoveTable cornerPermutation, layerEdgePermutation, slicePermutation;
+
+        PruningTable twistSlice, flipSlice, twistFlip;
+        PruningTable cornerSlice, layerEdgeSlice;
+
+        // isPhase2Move[m] for every move index, and the phase 2 moves in order.
+        std::array<bool, 18> isPhase2Move{};
+        std::vector<int> phase2Moves;
+
+        uint32_t solvedSlice = 0;
+    };
+
+    // Loaded (or generated) on first use.
+    static const Tables &tables();
+};
+
+
+#endif //RUBIKSSOLVER_TWOPHASE_HPP
@@ -0,0 +1,40 @@
+
+#ifndef RUBIKSSOLVER_VISITEDSET_HPP
+#define RUBIKSSOLVER_VISITEDSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The set of seen indices in [0, indexSize) for a breadth-first generator. It starts as an open addressing
+// hash set of the indices and turns into one bit per index once that takes less memory, so a few states
+// stay cheap and a nearly full search space costs indexSize / 8 bytes.
+class VisitedSet {
+public:
+    explicit VisitedSet(uint64_t indexSize);
+
+    // Marks index, false when it was already marked.
+    bool insert(uint64_t index);
+    bool contains(uint64_t index) const;
+
+    size_t size() const { return count; }
+    bool isBitset() const { return !bits.empty(); }
+    size_t memoryUsage() const { return (slots.size() + bits.size()) * sizeof(uint64_t); }
+
+private:
+    static constexpr uint64_t empty = ~0ULL;
+
+    uint64_t indexSize;
+    size_t count = 0;
+
+    // Power of two sized, at most half full.
+    std::vector<uint64_t> slots;
+    std::vector<uint64_t> bits;
+
+    size_t findSlot(uint64_t index) const;
+    void rehash(size_t numSlots);
+    void convertToBitset();
+};
+
+
+#endif //RUBIKSSOLVER_VISITEDSET_HPP
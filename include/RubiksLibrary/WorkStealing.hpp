@@ -0,0 +1,78 @@
+
+#ifndef RUBIKSSOLVER_WORKSTEALING_HPP
+#define RUBIKSSOLVER_WORKSTEALING_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a tree of tasks on a fixed number of threads. Every worker keeps its own deque: tasks it spawns go
+// on the back and it takes work from the back, so it stays on the subtree it is in. A worker that runs
+// dry steals from the front of another deque, which holds the oldest and usually largest pending subtree.
+//
+// The threads are started once and kept for every run(), waiting on a condition variable between runs and
+// whenever there is nothing left to steal.
+class WorkStealingExecutor {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingExecutor(unsigned workers);
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+    WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+    unsigned workers() const { return static_cast<unsigned>(queues.size()); }
+
+    // Queues task on the calling worker's deque, or on the first deque when called outside run().
+    void spawn(Task task);
+
+    // Runs everything queued, and everything that spawns, with the calling thread as one of the workers.
+    // Returns when all tasks are done and rethrows the first exception a task threw.
+    void run();
+
+    // Fewer tasks are waiting than there are workers, so a task that can split should.
+    bool needsWork() const { return queued.load(std::memory_order_relaxed) < queues.size(); }
+
+    // Runs body(begin, end) over [0, count) in chunks of at most grain, halving the range as it is stolen.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &body);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> queued = 0;
+    std::atomic<size_t> unfinished = 0;
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    // Guards the sleeping workers. idle counts the workers waiting for a task, so spawn() only takes the
+    // mutex when there is one to wake.
+    std::mutex sleepMutex;
+    std::condition_variable taskReady;
+    std::condition_variable runChanged;
+    std::atomic<unsigned> idle = 0;
+    size_t runs = 0;
+    unsigned running = 0;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+
+    bool take(unsigned worker, Task &task);
+    void work(unsigned worker);
+    void serve(unsigned worker);
+    void wakeIdle(bool all);
+};
+
+
+#endif //RUBIKSSOLVER_WORKSTEALING_HPP
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include "RubiksLibrary/Coordinate.hpp"
+#include "RubiksLibrary/WorkStealing.hpp"
+
+uint64_t fallingFactorial(const uint64_t n, const uint64_t k) {
+    uint64_t out = 1;
+    for (uint64_t i = 0; i < k; i++) {
+        out *= n - i;
+    }
+    return out;
+}
+
+uint64_t power(const uint64_t base, const uint64_t exponent) {
+    uint64_t out = 1;
+    for (uint64_t i = 0; i < exponent; i++) {
+        out *= base;
+    }
+    return out;
+}
+
+template<size_t Slots, size_t Size>
+void rankPieces(const std::array<uint8_t, Slots> &locations, const std::vector<int> &pieces, const std::array<uint8_t, Slots> &slotIndex,
+                const size_t numSlots, uint64_t &permutation, uint64_t &orientation) {
+    permutation = 0;
+    orientation = 0;
+
+    uint32_t used = 0;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        const uint8_t location = locations[pieces[i]];
+        const uint32_t index = slotIndex[location / Size];
+
+        permutation = permutation * (numSlots - i) + index - __builtin_popcount(used & ((1u << index) - 1));
+        orientation = orientation * Size + location % Size;
+        used |= 1u << index;
+    }
+}
+
+template<size_t Slots, size_t Size>
+void unrankPieces(std::array<uint8_t, Slots> &locations, const std::vector<int> &pieces, const std::vector<int> &slots,
+                  uint64_t permutation, uint64_t orientation) {
+    const size_t k = pieces.size();
+
+    std::array<uint8_t, Slots> digits{};
+    std::array<uint8_t, Slots> orientations{};
+    for (size_t i = k; i-- > 0;) {
+        digits[i] = static_cast<uint8_t>(permutation % (slots.size() - i));
+        permutation /= slots.size() - i;
+        orientations[i] = static_cast<uint8_t>(orientation % Size);
+        orientation /= Size;
+    }
+
+    std::array<bool, Slots> usedSlot{};
+    std::array<bool, Slots> placedPiece{};
+    uint32_t usedIndices = 0;
+    for (size_t i = 0; i < k; i++) {
+        size_t index = 0;
+        for (int skip = digits[i]; ; index++) {
+            if (usedIndices & (1u << index)) { continue; }
+            if (skip-- == 0) { break; }
+        }
+        usedIndices |= 1u << index;
+
+        const int slot = slots[index];
+        usedSlot[slot] = true;
+        placedPiece[pieces[i]] = true;
+        locations[pieces[i]] = static_cast<uint8_t>(slot * Size + orientations[i]);
+    }
+
+    size_t freeSlot = 0;
+    for (size_t piece = 0; piece < Slots; piece++) {
+        if (placedPiece[piece]) { continue; }
+        while (usedSlot[freeSlot]) { freeSlot++; }
+        locations[piece] = static_cast<uint8_t>(freeSlot * Size);
+        freeSlot++;
+    }
+}
+
+PieceCoordinate::PieceCoordinate(std::vector<int> cornerPieces, std::vector<int> edgePieces,
+                                 std::vector<int> cornerSlots, std::vector<int> edgeSlots)
+    : cornerPieces(std::move(cornerPieces)), edgePieces(std::move(edgePieces)),
+      cornerSlots(std::move(cornerSlots)), edgeSlots(std::move(edgeSlots)) {
+
+    if (this->cornerSlots.empty()) {
+        this->cornerSlots.resize(8);
+        std::iota(this->cornerSlots.begin(), this->cornerSlots.end(), 0);
+    }
+    if (this->edgeSlots.empty()) {
+        this->edgeSlots.resize(12);
+        std::iota(this->edgeSlots.begin(), this->edgeSlots.end(), 0);
+    }
+
+    if (this->cornerPieces.size() > this->cornerSlots.size() || this->edgePieces.size() > this->edgeSlots.size()) {
+        throw std::runtime_error("More tracked pieces than slots to put them in.");
+    }
+
+    for (size_t i = 0; i < this->cornerSlots.size(); i++) {
+        cornerSlotIndex[this->cornerSlots[i]] = static_cast<uint8_t>(i);
+    }
+    for (size_t i = 0; i < this->edgeSlots.size(); i++) {
+        edgeSlotIndex[this->edgeSlots[i]] = static_cast<uint8_t>(i);
+    }
+
+    cornerPermutations = fallingFactorial(this->cornerSlots.size(), this->cornerPieces.size());
+    cornerTwists = power(3, this->cornerPieces.size());
+    edgePermutations = fallingFactorial(this->edgeSlots.size(), this->edgePieces.size());
+    edgeFlips = power(2, this->edgePieces.size());
+}
+
+uint64_t PieceCoordinate::size() const {
+    return cornerPermutations * cornerTwists * edgePermutations * edgeFlips;
+}
+
+uint64_t PieceCoordinate::rank(const CubieCube &cube) const {
+    uint64_t cornerPermutation, cornerTwist, edgePermutation, edgeFlip;
+    rankPieces<8, 3>(cube.corners, cornerPieces, cornerSlotIndex, cornerSlots.size(), cornerPermutation, cornerTwist);
+    rankPieces<12, 2>(cube.edges, edgePieces, edgeSlotIndex, edgeSlots.size(), edgePermutation, edgeFlip);
+
+    return ((cornerPermutation * cornerTwists + cornerTwist) * edgePermutations + edgePermutation) * edgeFlips + edgeFlip;
+}
+
+CubieCube PieceCoordinate::unrank(uint64_t coordinate) const {
+    if (coordinate >= size()) {
+        throw std::runtime_error("Coordinate out of range.");
+    }
+
+    const uint64_t edgeFlip = coordinate % edgeFlips;
+    coordinate /= edgeFlips;
+    const uint64_t edgePermutation = coordinate % edgePermutations;
+    coordinate /= edgePermutations;
+    const uint64_t cornerTwist = coordinate % cornerTwists;
+    const uint64_t cornerPermutation = coordinate / cornerTwists;
+
+    CubieCube cube;
+    unrankPieces<8, 3>(cube.corners, cornerPieces, cornerSlots, cornerPermutation, cornerTwist);
+    unrankPieces<12, 2>(cube.edges, edgePieces, edgeSlots, edgePermutation, edgeFlip);
+
+    return cube;
+}
+
+CoordinateMoveTable CoordinateMoveTable::generate(const PieceCoordinate &coordinate, unsigned workers) {
+    CoordinateMoveTable table;
+    table.next.resize(coordinate.size() * 18);
+
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    WorkStealingExecutor executor(workers);
+    executor.parallelFor(coordinate.size(), 4096, [&](const size_t begin, const size_t end) {
+        for (uint64_t c = begin; c < end; c++) {
+            const CubieCube cube = coordinate.unrank(c);
+
+            for (int m = 0; m < 18; m++) {
+                CubieCube turned = cube;
+                turned.turnIndex(m);
+                table.next[c * 18 + m] = static_cast<uint32_t>(coordinate.rank(turned));
+            }
+        }
+    });
+
+    return table;
+}
+
+CoordinateMoveTable CoordinateMoveTable::loadOrGenerate(const PieceCoordinate &coordinate, const std::string &title) {
+    CoordinateMoveTable table;
+    if (table.load(title, coordinate.size())) {
+        return table;
+    }
+
+    std::cout << "Generating move table " << title << ".\n";
+    table = generate(coordinate);
+    table.save(title);
+    return table;
+}
+
+void CoordinateMoveTable::save(const std::string &title) const {
+    std::ofstream file(std::string(DATA_PATH) + "/" + title + ".bin", std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + std::string(DATA_PATH) + "/" + title + ".bin");
+    }
+
+    const uint64_t size = next.size();
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char *>(next.data()), static_cast<std::streamsize>(size * sizeof(uint32_t)));
+}
+
+bool CoordinateMoveTable::load(const std::string &title, const uint64_t expectedSize) {
+    std::ifstream file(std::string(DATA_PATH) + "/" + title + ".bin", std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    uint64_t size = 0;
+    file.read(reinterpret_cast<char *>(&size), sizeof(size));
+    if (!file || size != expectedSize * 18) {
+        return false;
+    }
+
+    next.resize(size);
+    file.read(reinterpret_cast<char *>(next.data()), static_cast<std::streamsize>(size * sizeof(uint32_t)));
+    return static_cast<bool>(file);
+}
+
+CrossAnd2CornersCoordinates::CrossAnd2CornersCoordinates(const CubieCube &cube)
+    : cross(static_cast<uint32_t>(CoordinateConst::crossEdges.rank(cube))),
+      slotEdges(static_cast<uint16_t>(CoordinateConst::slotEdges.rank(cube))),
+      corners(static_cast<uint16_t>(CoordinateConst::twoCorners.rank(cube))) {}
+
+CrossAnd2CornersCoordinates CrossAnd2CornersCoordinates::fromKey(const uint64_t key) {
+    CrossAnd2CornersCoordinates coordinates{CubieCube()};
+    coordinates.corners = static_cast<uint16_t>(key % 504);
+    coordinates.slotEdges = static_cast<uint16_t>(key / 504 % 528);
+    coordinates.cross = static_cast<uint32_t>(key / 504 / 528);
+    return coordinates;
+}
+
+void CrossAnd2CornersCoordinates::turnIndex(const int moveIndex, const std::array<CoordinateMoveTable, 3> &tables) {
+    cross = tables[0].turn(cross, moveIndex);
+    slotEdges = static_cast<uint16_t>(tables[1].turn(slotEdges, moveIndex));
+    corners = static_cast<uint16_t>(tables[2].turn(corners, moveIndex));
+}
+
+// Bit s is set when one of the cross edges is in edge slot s, for every cross coordinate.
+const std::vector<uint16_t> &crossSlotMasks() {
+    static const std::vector<uint16_t> masks = [] {
+        std::vector<uint16_t> out(CoordinateConst::crossEdges.size());
+        for (uint64_t c = 0; c < out.size(); c++) {
+            const CubieCube cube = CoordinateConst::crossEdges.unrank(c);
+            for (int e = 0; e < 4; e++) {
+                out[c] |= static_cast<uint16_t>(1u << (cube.edges[e] / 2));
+            }
+        }
+        return out;
+    }();
+    return masks;
+}
+
+uint64_t CrossAnd2CornersCoordinates::denseIndex() const {
+    const uint32_t mask = crossSlotMasks()[cross];
+
+    // slotEdges is (first * 11 + second among the other 11 slots) * 4 + flips.
+    const uint32_t permutation = slotEdges / 4;
+    const uint32_t first = permutation / 11;
+    const uint32_t secondDigit = permutation % 11;
+    const uint32_t second = secondDigit + (secondDigit >= first);
+
+    const uint32_t freeFirst = first - __builtin_popcount(mask & ((1u << first) - 1));
+    const uint32_t freeSecond = second - __builtin_popcount(mask & ((1u << second) - 1)) - (first < second);
+    const uint32_t freeSlotEdges = (freeFirst * 7 + freeSecond) * 4 + slotEdges % 4;
+
+    return (static_cast<uint64_t>(cross) * 224 + freeSlotEdges) * 504 + corners;
+}
+
+const std::array<CoordinateMoveTable, 3> &CrossAnd2CornersCoordinates::moveTables() {
+    static const std::array<CoordinateMoveTable, 3> tables = {
+        CoordinateMoveTable::loadOrGenerate(CoordinateConst::crossEdges, "moveTableCrossEdges"),
+        CoordinateMoveTable::loadOrGenerate(CoordinateConst::slotEdges, "moveTableSlotEdges"),
+        CoordinateMoveTable::loadOrGenerate(CoordinateConst::twoCorners, "moveTableTwoCorners")
+    };
+    return tables;
+}
@@ -0,0 +1,404 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RUBIKS_X86
+#include <immintrin.h>
+#endif
+
+#include "RubiksLibrary/CpuDispatch.hpp"
+#include "RubiksLibrary/PackedCube.hpp"
+
+namespace {
+
+inline void setBitsKernel(__int128 &x, const unsigned pos, const unsigned width, const unsigned value) {
+    const __int128 mask = ((static_cast<__int128>(1) << width) - 1) << pos;
+    x = (x & ~mask) | ((static_cast<__int128>(value) << pos) & mask);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Scalar kernels, always available.
+
+void turnScalar(uint8_t *facelets, const int moveIndex) {
+    const auto &moved = RubiksConst::movedFacelets[moveIndex];
+
+    std::array<uint8_t, 20> previous;
+    for (int k = 0; k < 20; k++) {
+        previous[k] = facelets[moved.source[k]];
+    }
+    for (int k = 0; k < 20; k++) {
+        facelets[moved.destination[k]] = previous[k];
+    }
+}
+
+__int128 hashNew2CornerScalar(const uint8_t *facelets) {
+    auto &colorComboLookupEdges = RubiksConst::colorComboLookupEdgesArray2Corner;
+    auto &colorComboLookupCorners = RubiksConst::colorComboLookupCornersArray2Corner;
+    auto &physicalPieces = RubiksConst::physicalPieces;
+
+    __int128 hash = 0;
+    for (int i = 0; i < 48; i++) {
+        auto &piece = physicalPieces[i];
+        const int ix0 = piece[0];
+        if (facelets[i] > facelets[ix0]) {continue;}
+
+        int position;
+        if (piece.size() == 1) {
+            const auto colorCombo = facelets[i] * 6 + facelets[ix0];
+            position = colorComboLookupEdges[colorCombo];
+        } else {
+            const int ix1 = piece[1];
+            if (facelets[i] > facelets[ix1]) {continue;}
+
+            const auto colorCombo = facelets[i] * 36 + facelets[ix0] * 6 + facelets[ix1];
+            position = colorComboLookupCorners[colorCombo];
+        }
+        setBitsKernel(hash, position, 6, i);
+    }
+    return hash;
+}
+
+size_t findKeyScalar(const __int128 *keys, const size_t count, const __int128 key) {
+    for (size_t i = 0; i < count; i++) {
+        if (keys[i] == key) { return i; }
+    }
+    return count;
+}
+
+#if defined(RUBIKS_X86)
+
+// ---------------------------------------------------------------------------------------------
+// Tables for the vector kernels.
+
+// Neighbouring facelets of every facelet on the same piece. Edges repeat their only neighbour so
+// that edges and corners share one "smallest color on the piece" test.
+std::array<std::array<unsigned char, 48>, 2> makeNeighbours() {
+    std::array<std::array<unsigned char, 48>, 2> neighbours{};
+    for (int i = 0; i < 48; i++) {
+        const auto &piece = RubiksConst::physicalPieces[i];
+        neighbours[0][i] = static_cast<unsigned char>(piece[0]);
+        neighbours[1][i] = static_cast<unsigned char>(piece.back());
+    }
+    return neighbours;
+}
+
+// hashNew2Corner bit position for the color combo own * 36 + first * 6 + second. Edges are stored at
+// own * 36 + first * 7, which never collides with a corner since corners have three distinct colors.
+std::array<uint8_t, 216> makeCombinedLookup2Corner() {
+    std::array<uint8_t, 216> lookup{};
+    for (int own = 0; own < 6; own++) {
+        for (int first = 0; first < 6; first++) {
+            lookup[own * 36 + first * 7] = RubiksConst::colorComboLookupEdgesArray2Corner[own * 6 + first];
+
+            for (int second = 0; second < 6; second++) {
+                if (first == second || own * 36 + first * 6 + second >= 150) { continue; }
+                lookup[own * 36 + first * 6 + second] = RubiksConst::colorComboLookupCornersArray2Corner[own * 36 + first * 6 + second];
+            }
+        }
+    }
+    return lookup;
+}
+
+// vpermb indices: facelet i of the result is taken from source[i]. Padding bytes map to themselves.
+std::array<uint8_t, 64> makePermuteIndices(const std::array<unsigned char, 48> &source) {
+    std::array<uint8_t, 64> indices{};
+    for (int i = 0; i < 64; i++) {
+        indices[i] = static_cast<uint8_t>(i < 48 ? source[i] : i);
+    }
+    return indices;
+}
+
+const auto neighbours = makeNeighbours();
+const auto combinedLookup2Corner = makeCombinedLookup2Corner();
+
+alignas(64) const std::array<PackedConst::LaneMasks, 2> neighbourMasks = {
+    PackedConst::makeLaneMasks(neighbours[0]),
+    PackedConst::makeLaneMasks(neighbours[1])
+};
+
+alignas(64) const std::array<std::array<uint8_t, 64>, 2> neighbourIndices = {
+    makePermuteIndices(neighbours[0]),
+    makePermuteIndices(neighbours[1])
+};
+
+std::array<std::array<uint8_t, 64>, 18> makeMoveIndices() {
+    std::array<std::array<uint8_t, 64>, 18> indices{};
+    for (int m = 0; m < 18; m++) {
+        indices[m] = makePermuteIndices(RubiksConst::movePermutations[m]);
+    }
+    return indices;
+}
+
+alignas(64) const auto moveIndices = makeMoveIndices();
+
+// The vector kernels only find which facelets carry the smallest color of their piece (the 20 the hash
+// records); the hash itself is then built from those bits in order, exactly like the scalar loop.
+inline __int128 hashFromReferences(const uint8_t *facelets, const uint8_t *first, const uint8_t *second, uint64_t references) {
+    __int128 hash = 0;
+    references &= 0xFFFFFFFFFFFFULL;
+
+    while (references) {
+        const int i = __builtin_ctzll(references);
+        references &= references - 1;
+
+        const int position = combinedLookup2Corner[facelets[i] * 36 + first[i] * 6 + second[i]];
+        setBitsKernel(hash, position, 6, i);
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------------------------
+// SSE4 (SSSE3 pshufb + SSE4.1 64-bit compares).
+
+__attribute__((target("ssse3,sse4.1")))
+inline void gatherSSE4(const uint8_t *in, const PackedConst::LaneMasks &masks, uint8_t *out) {
+    const __m128i source0 = _mm_load_si128(reinterpret_cast<const __m128i *>(in));
+    const __m128i source1 = _mm_load_si128(reinterpret_cast<const __m128i *>(in + 16));
+    const __m128i source2 = _mm_load_si128(reinterpret_cast<const __m128i *>(in + 32));
+
+    for (int lane = 0; lane < 3; lane++) {
+        __m128i result = _mm_shuffle_epi8(source0, _mm_load_si128(reinterpret_cast<const __m128i *>(&masks[0][16 * lane])));
+        result = _mm_or_si128(result, _mm_shuffle_epi8(source1, _mm_load_si128(reinterpret_cast<const __m128i *>(&masks[1][16 * lane]))));
+        result = _mm_or_si128(result, _mm_shuffle_epi8(source2, _mm_load_si128(reinterpret_cast<const __m128i *>(&masks[2][16 * lane]))));
+        _mm_store_si128(reinterpret_cast<__m128i *>(out + 16 * lane), result);
+    }
+}
+
+__attribute__((target("ssse3,sse4.1")))
+void turnSSE4(uint8_t *facelets, const int moveIndex) {
+    gatherSSE4(facelets, PackedConst::shuffleMasks[moveIndex], facelets);
+}
+
+__attribute__((target("ssse3,sse4.1")))
+__int128 hashNew2CornerSSE4(const uint8_t *facelets) {
+    alignas(64) std::array<uint8_t, 64> first{};
+    alignas(64) std::array<uint8_t, 64> second{};
+    gatherSSE4(facelets, neighbourMasks[0], first.data());
+    gatherSSE4(facelets, neighbourMasks[1], second.data());
+
+    uint64_t references = 0;
+    for (int lane = 0; lane < 3; lane++) {
+        const __m128i own = _mm_load_si128(reinterpret_cast<const __m128i *>(facelets + 16 * lane));
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(&first[16 * lane]));
+        const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(&second[16 * lane]));
+
+        const __m128i smallest = _mm_cmpeq_epi8(_mm_min_epu8(_mm_min_epu8(a, b), own), own);
+        references |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(smallest))) << (16 * lane);
+    }
+
+    return hashFromReferences(facelets, first.data(), second.data(), references);
+}
+
+__attribute__((target("ssse3,sse4.1")))
+size_t findKeySSE4(const __int128 *keys, const size_t count, const __int128 key) {
+    const __m128i target = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&key));
+    for (size_t i = 0; i < count; i++) {
+        const __m128i candidate = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi64(candidate, target)) == 0xFFFF) { return i; }
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX2. vpshufb still only shuffles within 128-bit lanes, so each source lane is broadcast first.
+
+__attribute__((target("avx2")))
+inline void gatherAVX2(const uint8_t *in, const PackedConst::LaneMasks &masks, uint8_t *out) {
+    __m256i low = _mm256_setzero_si256();
+    __m256i high = _mm256_setzero_si256();
+    for (int lane = 0; lane < 3; lane++) {
+        const __m256i source = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(in + 16 * lane)));
+        low = _mm256_or_si256(low, _mm256_shuffle_epi8(source, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&masks[lane][0]))));
+        high = _mm256_or_si256(high, _mm256_shuffle_epi8(source, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&masks[lane][32]))));
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i *>(out), low);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(out + 32), high);
+}
+
+__attribute__((target("avx2")))
+void turnAVX2(uint8_t *facelets, const int moveIndex) {
+    gatherAVX2(facelets, PackedConst::shuffleMasks[moveIndex], facelets);
+}
+
+__attribute__((target("avx2")))
+__int128 hashNew2CornerAVX2(const uint8_t *facelets) {
+    alignas(64) std::array<uint8_t, 64> first{};
+    alignas(64) std::array<uint8_t, 64> second{};
+    gatherAVX2(facelets, neighbourMasks[0], first.data());
+    gatherAVX2(facelets, neighbourMasks[1], second.data());
+
+    uint64_t references = 0;
+    for (int half = 0; half < 2; half++) {
+        const __m256i own = _mm256_load_si256(reinterpret_cast<const __m256i *>(facelets + 32 * half));
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(&first[32 * half]));
+        const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i *>(&second[32 * half]));
+
+        const __m256i smallest = _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_min_epu8(a, b), own), own);
+        references |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(smallest))) << (32 * half);
+    }
+
+    return hashFromReferences(facelets, first.data(), second.data(), references);
+}
+
+__attribute__((target("avx2")))
+size_t findKeyAVX2(const __int128 *keys, const size_t count, const __int128 key) {
+    const __m256i target = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&key)));
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m256i candidates = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+        const auto equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(candidates, target)));
+        if ((equal & 0xFFFF) == 0xFFFF) { return i; }
+        if ((equal >> 16) == 0xFFFF) { return i + 1; }
+    }
+    if (i < count && keys[i] == key) { return i; }
+    return count;
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX-512 (VBMI vpermb shuffles all 64 bytes at once). The maskz forms with every lane set keep GCC's
+// headers from reading an uninitialized pass-through operand.
+
+constexpr __mmask64 allBytes = ~0ULL;
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+void turnAVX512(uint8_t *facelets, const int moveIndex) {
+    const __m512i source = _mm512_load_si512(facelets);
+    const __m512i indices = _mm512_load_si512(moveIndices[moveIndex].data());
+    _mm512_store_si512(facelets, _mm512_maskz_permutexvar_epi8(allBytes, indices, source));
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+__int128 hashNew2CornerAVX512(const uint8_t *facelets) {
+    alignas(64) std::array<uint8_t, 64> first{};
+    alignas(64) std::array<uint8_t, 64> second{};
+
+    const __m512i own = _mm512_load_si512(facelets);
+    const __m512i a = _mm512_maskz_permutexvar_epi8(allBytes, _mm512_load_si512(neighbourIndices[0].data()), own);
+    const __m512i b = _mm512_maskz_permutexvar_epi8(allBytes, _mm512_load_si512(neighbourIndices[1].data()), own);
+    _mm512_store_si512(first.data(), a);
+    _mm512_store_si512(second.data(), b);
+
+    const uint64_t references = _mm512_cmple_epu8_mask(own, a) & _mm512_cmple_epu8_mask(own, b);
+    return hashFromReferences(facelets, first.data(), second.data(), references);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+size_t findKeyAVX512(const __int128 *keys, const size_t count, const __int128 key) {
+    const __m512i target = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&key)));
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m512i candidates = _mm512_loadu_si512(keys + i);
+        const auto equal = static_cast<unsigned>(_mm512_cmpeq_epi64_mask(candidates, target));
+        const unsigned bothHalves = equal & (equal >> 1) & 0x55;
+        if (bothHalves) { return i + __builtin_ctz(bothHalves) / 2; }
+    }
+    for (; i < count; i++) {
+        if (keys[i] == key) { return i; }
+    }
+    return count;
+}
+
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// Selection.
+
+CubeKernels kernelsFor(const CpuLevel level) {
+#if defined(RUBIKS_X86)
+    switch (level) {
+        case AVX512:
+            return {turnAVX512, hashNew2CornerAVX512, findKeyAVX512};
+        case AVX2:
+            return {turnAVX2, hashNew2CornerAVX2, findKeyAVX2};
+        case SSE4:
+            return {turnSSE4, hashNew2CornerSSE4, findKeySSE4};
+        case Scalar:
+            break;
+    }
+#endif
+    return {turnScalar, hashNew2CornerScalar, findKeyScalar};
+}
+
+// Constant-initialised to the scalar kernels so they are usable even before static initialisation
+// of this file has run; the selector below upgrades them at startup.
+CubeKernels activeKernels = {turnScalar, hashNew2CornerScalar, findKeyScalar};
+CpuLevel activeLevel = Scalar;
+
+}
+
+CpuLevel CpuDispatch::detect() {
+#if defined(RUBIKS_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi")) {
+        return AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1")) {
+        return SSE4;
+    }
+#endif
+    return Scalar;
+}
+
+CpuLevel CpuDispatch::level() {
+    return activeLevel;
+}
+
+void CpuDispatch::force(const CpuLevel level) {
+    if (level > detect()) {
+        throw std::runtime_error("CPU does not support kernel level " + name(level) + ".");
+    }
+
+    activeKernels = kernelsFor(level);
+    activeLevel = level;
+}
+
+const CubeKernels &CpuDispatch::kernels() {
+    return activeKernels;
+}
+
+std::string CpuDispatch::name(const CpuLevel level) {
+    switch (level) {
+        case Scalar: return "scalar";
+        case SSE4: return "sse4";
+        case AVX2: return "avx2";
+        case AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+CpuLevel CpuDispatch::parse(const std::string &name) {
+    for (const auto level : {Scalar, SSE4, AVX2, AVX512}) {
+        if (CpuDispatch::name(level) == name) { return level; }
+    }
+    throw std::runtime_error("Unknown kernel level '" + name + "', use scalar, sse4, avx2 or avx512.");
+}
+
+namespace {
+
+// Runs during static initialization, where an exception would terminate the program (or the Python
+// interpreter on import), so a bad RUBIKS_CPU_LEVEL only warns.
+struct KernelSelector {
+    KernelSelector() {
+        const char *forced = std::getenv("RUBIKS_CPU_LEVEL");
+        if (forced) {
+            try {
+                CpuDispatch::force(CpuDispatch::parse(forced));
+                return;
+            } catch (const std::runtime_error &e) {
+                std::cerr << "Ignoring RUBIKS_CPU_LEVEL: " << e.what() << "\n";
+            }
+        }
+        CpuDispatch::force(CpuDispatch::detect());
+    }
+};
+
+KernelSelector kernelSelector;
+
+}
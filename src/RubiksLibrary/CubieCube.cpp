@@ -0,0 +1,113 @@
+#include <stdexcept>
+
+#include "RubiksLibrary/CubieCube.hpp"
+
+// One bit per color on the given facelets, 0 when a color is out of range or repeats.
+template<size_t Size, typename Color>
+unsigned colorMask(const std::array<unsigned char, Size> &facelets, Color color) {
+    unsigned mask = 0;
+    for (const auto facelet : facelets) {
+        const short c = color(facelet);
+        if (c < 0 || c >= 6 || (mask & (1u << c))) { return 0; }
+        mask |= 1u << c;
+    }
+    return mask;
+}
+
+// Finds the piece whose solved colors are exactly the colors on the given facelets, or -1.
+template<size_t Slots, size_t Size>
+int findPiece(const std::array<short, 48> &cube, const std::array<std::array<unsigned char, Size>, Slots> &slotFacelets, const std::array<unsigned char, Size> &facelets) {
+    const unsigned mask = colorMask(facelets, [&cube](const unsigned char facelet) { return cube[facelet]; });
+    if (mask == 0) { return -1; }
+
+    for (size_t piece = 0; piece < Slots; piece++) {
+        if (colorMask(slotFacelets[piece], [](const unsigned char facelet) { return RubiksConst::solvedCube[facelet]; }) == mask) {
+            return static_cast<int>(piece);
+        }
+    }
+    return -1;
+}
+
+template<size_t Slots, size_t Size>
+void readPieces(const std::array<short, 48> &cube, const std::array<std::array<unsigned char, Size>, Slots> &slotFacelets, std::array<uint8_t, Slots> &locations) {
+    std::array<bool, Slots> found{};
+
+    for (size_t slot = 0; slot < Slots; slot++) {
+        const auto &facelets = slotFacelets[slot];
+        const int piece = findPiece(cube, slotFacelets, facelets);
+        if (piece == -1 || found[piece]) {
+            throw std::runtime_error("Facelets do not describe a valid cube.");
+        }
+        found[piece] = true;
+
+        const short firstColor = RubiksConst::solvedCube[slotFacelets[piece][0]];
+        size_t orientation = 0;
+        while (orientation < Size && cube[facelets[orientation]] != firstColor) { orientation++; }
+        if (orientation == Size) {
+            throw std::runtime_error("Facelets do not describe a valid cube.");
+        }
+
+        locations[piece] = static_cast<uint8_t>(slot * Size + orientation);
+    }
+}
+
+template<size_t Slots, size_t Size>
+void writePieces(std::array<short, 48> &cube, const std::array<std::array<unsigned char, Size>, Slots> &slotFacelets, const std::array<uint8_t, Slots> &locations) {
+    for (size_t piece = 0; piece < Slots; piece++) {
+        const auto &facelets = slotFacelets[locations[piece] / Size];
+        const size_t orientation = locations[piece] % Size;
+
+        for (size_t k = 0; k < Size; k++) {
+            cube[facelets[(orientation + k) % Size]] = RubiksConst::solvedCube[slotFacelets[piece][k]];
+        }
+    }
+}
+
+CubieCube::CubieCube() {
+    for (int p = 0; p < 8; p++) {
+        corners[p] = static_cast<uint8_t>(p * 3);
+    }
+    for (int p = 0; p < 12; p++) {
+        edges[p] = static_cast<uint8_t>(p * 2);
+    }
+}
+
+CubieCube::CubieCube(const std::array<short, 48> &cube) {
+    readPieces(cube, CubieConst::cornerFacelets, corners);
+    readPieces(cube, CubieConst::edgeFacelets, edges);
+
+    // A corner with two stickers swapped has the right colors but can't be written back.
+    if (toArray() != cube) {
+        throw std::runtime_error("Facelets do not describe a valid cube.");
+    }
+}
+
+CubieCube::CubieCube(const RubiksCube &cube): CubieCube(cube.cube) {}
+
+std::array<short, 48> CubieCube::toArray() const {
+    std::array<short, 48> cube{};
+    writePieces(cube, CubieConst::cornerFacelets, corners);
+    writePieces(cube, CubieConst::edgeFacelets, edges);
+
+    return cube;
+}
+
+void CubieCube::turn(const Move m) {
+    turnIndex(m.move - 'A');
+}
+
+void CubieCube::turnIndex(const int moveIndex) {
+    const auto &cornerMoves = CubieConst::cornerMoves[moveIndex];
+    const auto &edgeMoves = CubieConst::edgeMoves[moveIndex];
+
+    for (auto &location : corners) {
+        location = cornerMoves[location];
+    }
+    for (auto &location : edges) {
+        location = edgeMoves[location];
+    }
+}
+
+bool CubieCube::solved() const {
+    return *this == CubieCube();
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+
+#include "RubiksLibrary/ExternalTableBuilder.hpp"
+#include "RubiksLibrary/MappedTable.hpp"
+
+static constexpr size_t recordsPerRead = 1 << 14;
+
+static std::string dataPath(const std::string &name) {
+    return std::string(DATA_PATH) + "/" + name;
+}
+
+static uint64_t alignTo64(const uint64_t offset) {
+    return (offset + 63) / 64 * 64;
+}
+
+// Streams the records of one run file back in blocks.
+template<typename Record>
+class RunReader {
+public:
+    explicit RunReader(const std::string &path): file(path, std::ios::binary) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        refill();
+    }
+
+    bool done() const { return next == records.size(); }
+    const Record &current() const { return records[next]; }
+
+    void advance() {
+        if (++next == records.size()) { refill(); }
+    }
+
+private:
+    std::ifstream file;
+    std::vector<Record> records;
+    size_t next = 0;
+
+    void refill() {
+        records.resize(recordsPerRead);
+        file.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        records.resize(static_cast<size_t>(file.gcount()) / sizeof(Record));
+        next = 0;
+    }
+};
+
+template<typename Key>
+ExternalTableBuilder<Key>::ExternalTableBuilder(std::string title, const size_t maxRecordsInMemory)
+    : title(std::move(title)), maxRecordsInMemory(std::max<size_t>(maxRecordsInMemory, 1)) {
+    buffer.reserve(this->maxRecordsInMemory);
+}
+
+template<typename Key>
+ExternalTableBuilder<Key>::~ExternalTableBuilder() {
+    for (const auto &path : runPaths) {
+        std::remove(path.c_str());
+    }
+}
+
+template<typename Key>
+void ExternalTableBuilder<Key>::add(const Key key, const PackedMoves moves) {
+    buffer.push_back({key, moves});
+    if (buffer.size() == maxRecordsInMemory) {
+        spill();
+    }
+}
+
+template<typename Key>
+void ExternalTableBuilder<Key>::spill() {
+    if (buffer.empty()) { return; }
+
+    std::stable_sort(buffer.begin(), buffer.end(), [](const Record &a, const Record &b) {
+        return a.key < b.key || (a.key == b.key && a.moves.size() < b.moves.size());
+    });
+    const auto last = std::unique(buffer.begin(), buffer.end(), [](const Record &a, const Record &b) {
+        return a.key == b.key;
+    });
+
+    const auto path = dataPath(title + ".run" + std::to_string(runPaths.size()));
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>((last - buffer.begin()) * sizeof(Record)));
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+
+    runPaths.push_back(path);
+    buffer.clear();
+}
+
+template<typename Key>
+uint64_t ExternalTableBuilder<Key>::finish() {
+    spill();
+
+    std::vector<RunReader<Record>> readers;
+    readers.reserve(runPaths.size());
+    for (const auto &path : runPaths) {
+        readers.emplace_back(path);
+    }
+
+    // Smallest key first, then the shortest sequence, then the earliest run.
+    auto later = [&readers](const size_t a, const size_t b) {
+        const auto &x = readers[a].current();
+        const auto &y = readers[b].current();
+        if (x.key != y.key) { return y.key < x.key; }
+        if (x.moves.size() != y.moves.size()) { return y.moves.size() < x.moves.size(); }
+        return b < a;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t i = 0; i < readers.size(); i++) {
+        if (!readers[i].done()) { heap.push(i); }
+    }
+
+    // The values go to a side file until the number of keys, and with it the values offset, is known.
+    // The table is renamed into place once complete, like MappedTable::write.
+    const auto tablePath = dataPath(title + ".tbl");
+    const auto tmpPath = tablePath + ".tmp";
+    const auto valuesPath = dataPath(title + ".values");
+    std::ofstream table(tmpPath, std::ios::binary);
+    std::ofstream values(valuesPath, std::ios::binary);
+    if (!table.is_open() || !values.is_open()) {
+        throw std::runtime_error("Failed to open file: " + tmpPath);
+    }
+
+    MappedTableConst::Header header{};
+    std::memcpy(header.magic, MappedTableConst::magic, sizeof(header.magic));
+    header.version = MappedTableConst::version;
+    header.keyBytes = sizeof(Key);
+    header.valueBytes = sizeof(PackedMoves);
+    header.keysOffset = alignTo64(sizeof(header));
+
+    const std::vector<char> padding(64, 0);
+    table.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    table.write(padding.data(), static_cast<std::streamsize>(header.keysOffset - sizeof(header)));
+
+    uint64_t count = 0;
+    bool any = false;
+    Key previous{};
+    while (!heap.empty()) {
+        const size_t i = heap.top();
+        heap.pop();
+
+        const auto &record = readers[i].current();
+        if (!any || record.key != previous) {
+            table.write(reinterpret_cast<const char *>(&record.key), sizeof(Key));
+            values.write(reinterpret_cast<const char *>(&record.moves), sizeof(PackedMoves));
+            previous = record.key;
+            any = true;
+            count++;
+        }
+
+        readers[i].advance();
+        if (!readers[i].done()) { heap.push(i); }
+    }
+    values.close();
+
+    header.count = count;
+    header.valuesOffset = alignTo64(header.keysOffset + count * sizeof(Key));
+    table.write(padding.data(), static_cast<std::streamsize>(header.valuesOffset - header.keysOffset - count * sizeof(Key)));
+
+    if (count > 0) {
+        std::ifstream valuesIn(valuesPath, std::ios::binary);
+        table << valuesIn.rdbuf();
+    }
+    std::remove(valuesPath.c_str());
+
+    table.seekp(0);
+    table.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    table.close();
+    if (!table) {
+        throw std::runtime_error("Failed to write file: " + tmpPath);
+    }
+    if (std::rename(tmpPath.c_str(), tablePath.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + tmpPath + " to " + tablePath);
+    }
+
+    readers.clear();
+    for (const auto &path : runPaths) {
+        std::remove(path.c_str());
+    }
+    runPaths.clear();
+
+    return count;
+}
+
+template class ExternalTableBuilder<__int128>;
+template class ExternalTableBuilder<uint64_t>;
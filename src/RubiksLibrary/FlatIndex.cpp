@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <array>
+
+#include "RubiksLibrary/FlatIndex.hpp"
+
+template<typename Key>
+FlatIndex<Key>::FlatIndex(const std::unordered_map<Key, PackedMoves> &map) {
+    std::vector<Key> sorted;
+    sorted.reserve(map.size());
+    for (const auto &[key, moves] : map) {
+        sorted.push_back(key);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    // An in-order walk of the implicit tree (children of k are 2k and 2k + 1) visits the slots in sorted order.
+    keys.resize(sorted.size() + 1);
+    values.resize(keys.size());
+
+    size_t next = 0;
+    size_t k = 1;
+    std::vector<size_t> stack;
+    while (next < sorted.size()) {
+        while (k < keys.size()) {
+            stack.push_back(k);
+            k = 2 * k;
+        }
+        k = stack.back();
+        stack.pop_back();
+
+        values[k] = map.at(sorted[next]);
+        keys[k] = sorted[next++];
+
+        k = 2 * k + 1;
+    }
+}
+
+template<typename Key>
+size_t FlatIndex<Key>::search(const Key key) const {
+    constexpr size_t keysPerLine = 64 / sizeof(Key);
+
+    const Key *tree = keys.data();
+    const size_t n = size();
+
+    size_t k = 1;
+    while (k <= n) {
+        __builtin_prefetch(tree + k * keysPerLine);
+        k = 2 * k + (tree[k] < key);
+    }
+    // Undo the right turns taken after the last left turn, which was at the lower bound.
+    k >>= __builtin_ffsll(static_cast<long long>(~k));
+
+    return (k != 0 && tree[k] == key) ? k : 0;
+}
+
+template<typename Key>
+bool FlatIndex<Key>::contains(const Key key) const {
+    return search(key) != 0;
+}
+
+template<typename Key>
+std::optional<PackedMoves> FlatIndex<Key>::find(const Key key) const {
+    const size_t k = search(key);
+    if (k == 0) {
+        return std::nullopt;
+    }
+
+    return values[k];
+}
+
+template<typename Key>
+void FlatIndex<Key>::findBatch(const Key *batch, const size_t count, std::optional<PackedMoves> *out) const {
+    constexpr size_t keysPerLine = 64 / sizeof(Key);
+    constexpr size_t maxBatch = 18;
+
+    const Key *tree = keys.data();
+    const size_t n = size();
+
+    for (size_t begin = 0; begin < count; begin += maxBatch) {
+        const size_t end = std::min(count, begin + maxBatch);
+
+        std::array<size_t, maxBatch> k;
+        k.fill(1);
+
+        bool searching = true;
+        while (searching) {
+            searching = false;
+            for (size_t i = begin; i < end; i++) {
+                size_t &node = k[i - begin];
+                if (node > n) { continue; }
+
+                __builtin_prefetch(tree + node * keysPerLine);
+                node = 2 * node + (tree[node] < batch[i]);
+                searching = true;
+            }
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            size_t node = k[i - begin];
+            node >>= __builtin_ffsll(static_cast<long long>(~node));
+
+            if (node != 0 && tree[node] == batch[i]) {
+                out[i] = values[node];
+            } else {
+                out[i] = std::nullopt;
+            }
+        }
+    }
+}
+
+template<typename Key>
+size_t FlatIndex<Key>::maxLength() const {
+    size_t longest = 0;
+    for (const auto &moves : values) {
+        longest = std::max(longest, moves.size());
+    }
+    return longest;
+}
+
+template class FlatIndex<__int128>;
+template class FlatIndex<uint64_t>;
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "RubiksLibrary/HashedCube.hpp"
+
+HashedCube::HashedCube(const std::array<short, 48> &cube) {
+    auto &colorComboLookupEdges = RubiksConst::colorComboLookupEdgesArray2Corner;
+    auto &colorComboLookupCorners = RubiksConst::colorComboLookupCornersArray2Corner;
+    auto &physicalPieces = RubiksConst::physicalPieces;
+
+    int numUntracked = 0;
+    for (int i = 0; i < 48; i++) {
+        auto &piece = physicalPieces[i];
+        if (cube[i] > cube[piece[0]]) {continue;}
+
+        int position;
+        if (piece.size() == 1) {
+            position = colorComboLookupEdges[cube[i] * 6 + cube[piece[0]]];
+        } else {
+            if (cube[i] > cube[piece[1]]) {continue;}
+            position = colorComboLookupCorners[cube[i] * 36 + cube[piece[0]] * 6 + cube[piece[1]]];
+        }
+
+        if (position == 0) {
+            if (numUntracked == 12) {
+                throw std::runtime_error("Facelets do not describe a valid cube.");
+            }
+            untracked[numUntracked++] = static_cast<uint8_t>(i);
+            continue;
+        }
+
+        const auto *field = std::find(HashedConst::trackedPositions.begin(), HashedConst::trackedPositions.end(), position);
+        tracked[field - HashedConst::trackedPositions.begin()] = static_cast<uint8_t>(i);
+    }
+
+    if (numUntracked != 12) {
+        throw std::runtime_error("Facelets do not describe a valid cube.");
+    }
+
+    hash = *std::max_element(untracked.begin(), untracked.end());
+    for (int k = 0; k < 8; k++) {
+        hash |= static_cast<__int128>(tracked[k]) << HashedConst::trackedPositions[k];
+    }
+}
+
+HashedCube::HashedCube(const RubiksCube &cube): HashedCube(cube.cube) {}
+
+void HashedCube::turn(const Move m) {
+    turnIndex(m.move - 'A');
+}
+
+void HashedCube::turnIndex(const int moveIndex) {
+    const auto &destinations = HashedConst::faceletDestinations[moveIndex];
+
+    // Pieces the move doesn't touch keep their facelet, so their xor is zero and the field is left alone.
+    for (int k = 0; k < 8; k++) {
+        const uint8_t moved = destinations[tracked[k]];
+        hash ^= static_cast<__int128>(tracked[k] ^ moved) << HashedConst::trackedPositions[k];
+        tracked[k] = moved;
+    }
+
+    uint8_t highest = 0;
+    for (auto &facelet : untracked) {
+        facelet = destinations[facelet];
+        highest = std::max(highest, facelet);
+    }
+    hash = (hash & ~static_cast<__int128>(63)) | highest;
+}
+
+// Slot and orientation of the piece whose reference facelet is i, the slots numbered separately for
+// edges and corners in the order of their lowest facelet.
+struct FaceletPiece {
+    bool corner = false;
+    uint8_t slot = 0;
+    uint8_t orientation = 0;
+};
+
+static std::array<FaceletPiece, 48> makeFaceletPieces() {
+    std::array<FaceletPiece, 48> pieces{};
+    uint8_t edges = 0;
+    uint8_t corners = 0;
+    for (int i = 0; i < 48; i++) {
+        const auto &others = RubiksConst::physicalPieces[i];
+        if (*std::min_element(others.begin(), others.end()) < i) {continue;}
+
+        std::vector<int> facelets = others;
+        facelets.push_back(i);
+        std::sort(facelets.begin(), facelets.end());
+        const bool corner = facelets.size() == 3;
+        const uint8_t slot = corner ? corners++ : edges++;
+        for (size_t k = 0; k < facelets.size(); k++) {
+            pieces[facelets[k]] = {corner, slot, static_cast<uint8_t>(k)};
+        }
+    }
+    return pieces;
+}
+
+static const std::array<FaceletPiece, 48> faceletPieces = makeFaceletPieces();
+
+uint64_t HashedCube::denseIndex(const __int128 hash) {
+    std::array<uint8_t, 8> tracked{};
+    for (int k = 0; k < 8; k++) {
+        tracked[k] = static_cast<uint8_t>((hash >> HashedConst::trackedPositions[k]) & 63);
+    }
+    return denseIndex(tracked);
+}
+
+uint64_t HashedCube::denseIndex(const std::array<uint8_t, 8> &tracked) {
+    uint32_t usedEdges = 0;
+    uint32_t usedCorners = 0;
+    uint64_t index = 0;
+    for (const uint8_t facelet : tracked) {
+        const auto &piece = faceletPieces[facelet];
+        auto &used = piece.corner ? usedCorners : usedEdges;
+        const uint32_t orientations = piece.corner ? 3 : 2;
+        const uint32_t freeSlots = (piece.corner ? 8 : 12) - __builtin_popcount(used);
+
+        const uint32_t freeSlot = piece.slot - __builtin_popcount(used & ((1u << piece.slot) - 1));
+        index = index * freeSlots * orientations + freeSlot * orientations + piece.orientation;
+        used |= 1u << piece.slot;
+    }
+    return index;
+}
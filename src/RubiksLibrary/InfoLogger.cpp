@@ -5,7 +5,7 @@
 
 #include "RubiksLibrary/InfoLogger.hpp"
 
-InfoLogger::InfoLogger() {
+InfoLogger::InfoLogger(const bool enabled): _enabled(enabled) {
 	_prevPrintTime = std::chrono::high_resolution_clock::now();
 }
 
@@ -33,6 +33,8 @@ double progressPercent(const std::vector<char>& state) {
 }
 
 void InfoLogger::logg(const std::vector<char>& moves) {
+	if (!_enabled) { return; }
+
 	_counter++;
 	if (_counter % 1000 != 0) { return; }
 	_counter = 0;
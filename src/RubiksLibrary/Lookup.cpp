@@ -2,11 +2,26 @@
 #include <iostream>
 #include <chrono>
 #include <fstream>
+#include <filesystem>
 #include <ranges>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "RubiksLibrary/Move.hpp"
 #include "RubiksLibrary/Lookup.hpp"
 #include "RubiksLibrary/InfoLogger.hpp"
+#include "RubiksLibrary/Coordinate.hpp"
+#include "RubiksLibrary/HashedCube.hpp"
+#include "RubiksLibrary/WorkStealing.hpp"
+#include "RubiksLibrary/VisitedSet.hpp"
+#include "RubiksLibrary/ExternalTableBuilder.hpp"
 
 uint64_t Lookup::hashF(const std::array<unsigned int, 4> &num, uint32_t seed) {
     uint64_t hash_value = 0x811C9DC5 ^ seed; // FNV offset basis XOR seed
@@ -303,7 +318,7 @@ void generateLookupCrossAnd3Corners(
 }
 
 void generateLookupNewHashRec2Corner(
-    std::unordered_map<__int128, std::vector<char>> &map,
+    std::unordered_map<__int128, PackedMoves> &map,
     std::vector<char> &moves,
     RubiksCube &cube,
     InfoLogger &logger,
@@ -347,40 +362,374 @@ void generateLookupNewHashRec2Corner(
     }
 }
 
-void Lookup::generateLookupNewHash2Corner(const int depth) {
+void generateLookupNewHashRec2CornerOnDisk(
+    ExternalTableBuilder<__int128> &builder,
+    std::vector<char> &moves,
+    RubiksCube &cube,
+    const int depth) {
+
+    builder.add(cube.hashNew2Corner(), moves);
+    if (depth == 1) {return;}
+
+    const auto size = moves.size();
+    const Move prevMove = size > 0 ? Move(moves[size - 1]) : Move{7, 7};
+    const Move doublePrevMove = size > 1 ? Move(moves[size - 2]) : Move{7, 7};
+
+    for (auto m : RubiksConst::everyMove) {
+        if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+        moves.push_back(m.move);
+        cube.turn(m);
+        generateLookupNewHashRec2CornerOnDisk(builder, moves, cube, depth - 1);
+        cube.turn(m.face, 4 - m.rotations);
+        moves.pop_back();
+    }
+}
+
+void Lookup::generateLookupNewHash2CornerOnDisk(const int depth, const size_t maxRecordsInMemory) {
     const auto start = std::chrono::high_resolution_clock::now();
 
+    const std::string title = "newHashMap2CornersConstructedDepth" + std::to_string(depth);
+    ExternalTableBuilder<__int128> builder(title, maxRecordsInMemory);
+
     std::vector<char> moves;
     moves.reserve(10);
     RubiksCube cube;
-    InfoLogger logger;
-
-    // Test splitting it
-    for (auto m : MoveConst::moves) {
-        newHashMap2Corner.clear();
-        newHashMap2Corner[cube.hashNew2Corner()] = moves;
+    builder.add(cube.hashNew2Corner(), moves);
 
+    for (auto m : RubiksConst::everyMove) {
+        moves.push_back(m.move);
         cube.turn(m);
-        moves.push_back(m);
-        generateLookupNewHashRec2Corner(newHashMap2Corner, moves, cube, logger, depth);
-        Move mov{m};
-        cube.turn(mov.face, 4 - mov.rotations);
+        generateLookupNewHashRec2CornerOnDisk(builder, moves, cube, depth);
+        cube.turn(m.face, 4 - m.rotations);
         moves.pop_back();
 
-        std::string title = "newHashMap2CornersMove";
-        title += m;
-        title += "Depth" + std::to_string(depth);
-        Lookup::save(newHashMap2Corner, title);
+        std::cout << "Finished first move " << m.move << ", " << builder.numRuns() << " runs on disk.\n";
+    }
+
+    const auto count = builder.finish();
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto durLookup = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "Size of newHash (2 Corner) table " << title << ".tbl is " << count << " in " << durLookup.count() / 1000 / 1000 << " seconds." << "\n";
+}
+
+// Which merge bucket a newHash key goes to. std::hash<__int128> leaves these keys badly spread, so mix both halves.
+size_t mergeBucket(const __int128 key, const size_t numBuckets) {
+    uint64_t x = static_cast<uint64_t>(key) ^ static_cast<uint64_t>(key >> 64) * 0x9e3779b97f4a7c15ULL;
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 29;
+    return x % numBuckets;
+}
+
+static std::string tablePath(const std::string &title) {
+    return std::string(DATA_PATH) + "/" + title + ".txt";
+}
+
+// Forces what was written to path onto the disk. Also works on a directory outside Windows, which makes a
+// rename inside it durable.
+static void syncToDisk(const std::string &path) {
+#if defined(_WIN32)
+    const int fd = _open(path.c_str(), _O_WRONLY);
+    const bool synced = fd >= 0 && _commit(fd) == 0;
+    if (fd >= 0) { _close(fd); }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    const bool synced = fd >= 0 && ::fsync(fd) == 0;
+    if (fd >= 0) { ::close(fd); }
+#endif
+    if (!synced) {
+        throw std::runtime_error("Failed to sync " + path + " to disk.");
+    }
+}
+
+// Checkpoints are ordinary tables written by save(). They are written under a temporary name, synced and
+// renamed into place, so a checkpoint that exists is always complete, even after a crash.
+template<typename Map>
+static void saveCheckpoint(Map &map, const std::string &title) {
+    Lookup::save(map, title + "Tmp");
+    syncToDisk(tablePath(title + "Tmp"));
+    std::filesystem::rename(tablePath(title + "Tmp"), tablePath(title));
+#if !defined(_WIN32)
+    syncToDisk(DATA_PATH);
+#endif
+}
+
+static std::string shardTitle(const std::string &title, const char firstMove) {
+    return title + "Shard" + firstMove;
+}
+
+static void generateNewHash2Corner(
+    std::unordered_map<__int128, PackedMoves> &table,
+    const int depth,
+    unsigned workers,
+    const bool resume) {
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    const std::string title = "newHashMap2CornersConstructedDepth" + std::to_string(depth);
+
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t numBuckets = 4 * workers;
+    WorkStealingExecutor executor(workers);
+
+    // Every first move is its own DFS, the shard is then split into buckets by moving its nodes.
+    std::vector<std::vector<std::unordered_map<__int128, PackedMoves>>> shards(18);
+    for (size_t i = 0; i < shards.size(); i++) {
+        executor.spawn([&, i]() {
+            std::unordered_map<__int128, PackedMoves> shard;
+            const char m = MoveConst::moves[i];
+            std::string checkpoint = shardTitle(title, m);
+
+            if (resume && std::filesystem::exists(tablePath(checkpoint))) {
+                Lookup::load(shard, checkpoint);
+            } else {
+                std::vector<char> moves;
+                moves.reserve(10);
+                RubiksCube cube;
+                InfoLogger logger(false);
+
+                shard[cube.hashNew2Corner()] = moves;
+
+                cube.turn(m);
+                moves.push_back(m);
+                generateLookupNewHashRec2Corner(shard, moves, cube, logger, depth);
+                saveCheckpoint(shard, checkpoint);
+            }
+
+            auto &buckets = shards[i];
+            buckets.resize(numBuckets);
+            while (!shard.empty()) {
+                auto node = shard.extract(shard.begin());
+                buckets[mergeBucket(node.key(), numBuckets)].insert(std::move(node));
+            }
+
+            std::cout << "Finished first move " << m << ".\n";
+        });
+    }
+    executor.run();
+
+    // Shards are merged in first move order and only a shorter sequence replaces a key, like combineLookups.
+    std::vector<std::unordered_map<__int128, PackedMoves>> merged(numBuckets);
+    executor.parallelFor(numBuckets, 1, [&](const size_t begin, const size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            for (auto &buckets : shards) {
+                auto &part = buckets[b];
+                while (!part.empty()) {
+                    auto node = part.extract(part.begin());
+                    auto it = merged[b].find(node.key());
+                    if (it == merged[b].end()) {
+                        merged[b].insert(std::move(node));
+                    } else if (node.mapped().size() < it->second.size()) {
+                        it->second = node.mapped();
+                    }
+                }
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (const auto &bucket : merged) {
+        total += bucket.size();
+    }
+
+    table.clear();
+    table.reserve(total);
+    for (auto &bucket : merged) {
+        table.merge(bucket);
+    }
+
+    Lookup::save(table, title);
+    for (const char m : MoveConst::moves) {
+        std::filesystem::remove(tablePath(shardTitle(title, m)));
+    }
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto durLookup = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "Size of newHash (2 Corner) table is " << table.size() << " in " << durLookup.count() / 1000 / 1000 << " seconds." << "\n";
+}
+
+void Lookup::generateLookupNewHash2Corner(const int depth, const unsigned workers) {
+    generateNewHash2Corner(newHashMap2Corner, depth, workers, false);
+}
+
+void Lookup::resumeLookupNewHash2Corner(const int depth, const unsigned workers) {
+    generateNewHash2Corner(newHashMap2Corner, depth, workers, true);
+}
+
+void generateLookupCoordinateRec2Corner(
+    std::unordered_map<uint64_t, PackedMoves> &map,
+    std::vector<char> &moves,
+    CrossAnd2CornersCoordinates coordinates,
+    const std::array<CoordinateMoveTable, 3> &tables,
+    InfoLogger &logger,
+    const int depth) {
+
+    logger.incrementStates();
+    logger.logg(moves);
+
+    auto it = map.find(coordinates.key());
+    if (it != map.end()) {
+        if (moves.size() < it->second.size()) {
+            it->second = moves;
+        }
+    } else {
+        map.emplace(coordinates.key(), moves);
+    }
+
+    if (depth == 0) {return;}
+
+    const auto size = moves.size();
+    Move prevMove {7, 7};
+    Move doublePrevMove {7, 7};
+
+    if (size > 1) {
+        prevMove = Move(moves[size - 1]);
+        doublePrevMove = Move(moves[size - 2]);
+    } else if (size > 0) {
+        prevMove = Move(moves[size - 1]);
     }
 
-    // END Test splitting it
+    for (auto m : RubiksConst::everyMove) {
+        if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
 
-    // generateLookupNewHashRec2Corner(newHashMap2Corner, moves, cube, logger, depth + 1);
+        CrossAnd2CornersCoordinates next = coordinates;
+        next.turnIndex(m.move - 'A', tables);
+
+        moves.push_back(m.move);
+        generateLookupCoordinateRec2Corner(map, moves, next, tables, logger, depth - 1);
+        moves.pop_back();
+    }
+}
+
+void Lookup::generateLookupCoordinate2Corner(const int depth) {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<char> moves;
+    moves.reserve(10);
+    InfoLogger logger;
+
+    coordinateMap2Corner.clear();
+    const CrossAnd2CornersCoordinates solved{CubieCube()};
+    generateLookupCoordinateRec2Corner(coordinateMap2Corner, moves, solved, CrossAnd2CornersCoordinates::moveTables(), logger, depth);
+
+    Lookup::save(coordinateMap2Corner, "coordinateMap2CornerDepth" + std::to_string(depth));
+    MappedTable<uint64_t>::write(coordinateMap2Corner, "coordinateMap2CornerDepth" + std::to_string(depth));
 
     const auto end = std::chrono::high_resolution_clock::now();
     const auto durLookup = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    std::cout << "Size of newHash (2 Corner) table is " << newHashMap2Corner.size() << " in " << durLookup.count() / 1000 / 1000 << " seconds." << "\n";
+    std::cout << "Size of coordinate (2 Corner) table is " << coordinateMap2Corner.size() << " in " << durLookup.count() / 1000 / 1000 << " seconds." << "\n";
+}
+
+// Starts from the table saved as startTitle when there is one. The visited set and the deepest layer are
+// rebuilt from the table itself, so any complete breadth-first table (a checkpoint, or a finished table of
+// a smaller depth) is all a run needs to continue.
+static void generateCoordinate2CornerBreadthFirst(
+    std::unordered_map<uint64_t, PackedMoves> &table,
+    const int depth,
+    const std::string &startTitle) {
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    const std::string title = "coordinateMap2CornerDepth" + std::to_string(depth);
+    const std::string checkpoint = title + "Layers";
+
+    struct Node {
+        CrossAnd2CornersCoordinates coordinates;
+        PackedMoves moves;
+    };
+
+    const auto &tables = CrossAnd2CornersCoordinates::moveTables();
+    VisitedSet visited(CrossAnd2CornersCoordinates::denseSize);
+
+    const CrossAnd2CornersCoordinates solved{CubieCube()};
+    table.clear();
+
+    std::vector<Node> layer;
+    int finishedLayers = 0;
+    if (!startTitle.empty() && std::filesystem::exists(tablePath(startTitle))) {
+        std::string name = startTitle;
+        Lookup::load(table, name);
+
+        for (const auto &[key, moves] : table) {
+            visited.insert(CrossAnd2CornersCoordinates::fromKey(key).denseIndex());
+            finishedLayers = std::max(finishedLayers, static_cast<int>(moves.size()));
+        }
+        for (const auto &[key, moves] : table) {
+            if (moves.size() == static_cast<size_t>(finishedLayers)) {
+                layer.push_back({CrossAnd2CornersCoordinates::fromKey(key), moves});
+            }
+        }
+
+        // An uninterrupted run expands every layer in move order.
+        std::sort(layer.begin(), layer.end(), [](const Node &a, const Node &b) {
+            return a.moves.toVector() < b.moves.toVector();
+        });
+        std::cout << "Continuing " << startTitle << " after depth " << finishedLayers << " with " << table.size() << " states.\n";
+    } else {
+        table.emplace(solved.key(), PackedMoves());
+        visited.insert(solved.denseIndex());
+        layer.push_back({solved, PackedMoves()});
+    }
+
+    for (int d = finishedLayers; d < depth; d++) {
+        std::vector<Node> next;
+
+        for (const auto &[coordinates, moves] : layer) {
+            const auto size = moves.size();
+            const Move prevMove = size > 0 ? Move(moves[size - 1]) : Move{7, 7};
+            const Move doublePrevMove = size > 1 ? Move(moves[size - 2]) : Move{7, 7};
+
+            for (auto m : RubiksConst::everyMove) {
+                if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+                CrossAnd2CornersCoordinates child = coordinates;
+                child.turnIndex(m.move - 'A', tables);
+                if (!visited.insert(child.denseIndex())) { continue;}
+
+                PackedMoves childMoves = moves;
+                childMoves.push_back(m.move);
+                table.emplace(child.key(), childMoves);
+                next.push_back({child, childMoves});
+            }
+        }
+
+        std::cout << "Depth " << d + 1 << ": " << next.size() << " new states, visited set uses " << visited.memoryUsage() / 1000 << "kB.\n";
+        layer.swap(next);
+
+        if (d + 1 < depth) {
+            saveCheckpoint(table, checkpoint);
+        }
+    }
+
+    Lookup::save(table, title);
+    MappedTable<uint64_t>::write(table, title);
+    std::filesystem::remove(tablePath(checkpoint));
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto durLookup = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "Size of coordinate (2 Corner) table is " << table.size() << " in " << durLookup.count() / 1000 / 1000 << " seconds." << "\n";
+}
+
+void Lookup::generateLookupCoordinate2CornerBreadthFirst(const int depth) {
+    generateCoordinate2CornerBreadthFirst(coordinateMap2Corner, depth, "");
+}
+
+void Lookup::resumeLookupCoordinate2CornerBreadthFirst(const int depth) {
+    generateCoordinate2CornerBreadthFirst(coordinateMap2Corner, depth, "coordinateMap2CornerDepth" + std::to_string(depth) + "Layers");
+}
+
+void Lookup::extendLookupCoordinate2Corner(const int fromDepth, const int toDepth) {
+    const std::string from = "coordinateMap2CornerDepth" + std::to_string(fromDepth);
+    if (!std::filesystem::exists(tablePath(from))) {
+        throw std::runtime_error("Failed to open file: " + tablePath(from));
+    }
+    generateCoordinate2CornerBreadthFirst(coordinateMap2Corner, toDepth, from);
 }
 
 void Lookup::makeWholeCube(int depth) {
@@ -465,6 +814,50 @@ void Lookup::convertAndSave(std::map<std::array<unsigned int, 4>, std::vector<ch
     save(smallerMap, title);
 }
 
+void Lookup::makeDistanceTables2Corner(const int bitsPerState) {
+    const auto &tables = CrossAnd2CornersCoordinates::moveTables();
+    const CrossAnd2CornersCoordinates solved{CubieCube()};
+    const std::string bits = std::to_string(bitsPerState);
+
+    crossCornersDistance = PruningTable::loadOrGenerate(
+        {&tables[0], &tables[2]}, {CoordinateConst::crossEdges.size(), CoordinateConst::twoCorners.size()},
+        solved.cross * CoordinateConst::twoCorners.size() + solved.corners, bitsPerState, "distanceCrossCorners" + bits);
+    crossSlotEdgesDistance = PruningTable::loadOrGenerate(
+        {&tables[0], &tables[1]}, {CoordinateConst::crossEdges.size(), CoordinateConst::slotEdges.size()},
+        solved.cross * CoordinateConst::slotEdges.size() + solved.slotEdges, bitsPerState, "distanceCrossSlotEdges" + bits);
+}
+
+int Lookup::distance2Corner(const CrossAnd2CornersCoordinates &coordinates) const {
+    if (!crossCornersDistance.isOpen() || !crossSlotEdgesDistance.isOpen()) { return 0; }
+
+    return std::max(
+        crossCornersDistance.distance(coordinates.cross * CoordinateConst::twoCorners.size() + coordinates.corners),
+        crossSlotEdgesDistance.distance(coordinates.cross * CoordinateConst::slotEdges.size() + coordinates.slotEdges));
+}
+
+void Lookup::buildIndexes() {
+    newHashIndex2Corner = FlatIndex(newHashMap2Corner);
+    newHashIndex3Corner = FlatIndex(newHashMap3Corner);
+
+    std::unordered_map<__int128, PackedMoves>().swap(newHashMap2Corner);
+    std::unordered_map<__int128, PackedMoves>().swap(newHashMap3Corner);
+}
+
+void Lookup::buildParentTables() {
+    newHashParents2Corner = ParentMoveTable(newHashMap2Corner, HashedCube::denseSize, [](const __int128 key) {
+        return HashedCube::denseIndex(key);
+    });
+
+    std::unordered_map<__int128, PackedMoves>().swap(newHashMap2Corner);
+}
+
+void Lookup::convertToMappedTable(const std::string &title) {
+    std::unordered_map<__int128, PackedMoves> map;
+    std::string name = title;
+    load(map, name);
+    MappedTable<__int128>::write(map, title);
+}
+
 void Lookup::makeCrossAnd3Corners(int depth) {
     auto start = std::chrono::high_resolution_clock::now();
     RubiksCube cube;
@@ -492,8 +885,12 @@ std::string bigIntToStr(__int128 x) {
     return s;
 }
 
-void Lookup::save(std::unordered_map<__int128, std::vector<char>>& map, const std::string& title) {
-    std::ofstream file(static_cast<std::string>(DATA_PATH) + "/" + title + ".txt");
+void Lookup::save(std::unordered_map<__int128, PackedMoves>& map, const std::string& title) {
+    const std::string path = static_cast<std::string>(DATA_PATH) + "/" + title + ".txt";
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
 
     for (const auto & [fst, snd] : map) {
         auto s = bigIntToStr(fst);
@@ -503,13 +900,43 @@ void Lookup::save(std::unordered_map<__int128, std::vector<char>>& map, const st
         }
         file << s;
 
-        for (auto &m : snd) {
+        for (auto &m : snd.unpack()) {
             file << m;
         }
 
         file << "\n";
     }
     file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+void Lookup::save(std::unordered_map<uint64_t, PackedMoves>& map, const std::string& title) {
+    const std::string path = static_cast<std::string>(DATA_PATH) + "/" + title + ".txt";
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    for (const auto & [fst, snd] : map) {
+        auto s = std::to_string(fst);
+
+        for (auto i = 0; i < 20 - s.length(); i++) {
+            file << "A";
+        }
+        file << s;
+
+        for (auto &m : snd.unpack()) {
+            file << m;
+        }
+
+        file << "\n";
+    }
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
 }
 
 void Lookup::save(std::set<std::array<unsigned int, 4>>& map, const std::string& title) {
@@ -642,12 +1069,59 @@ static __int128 strToBigInt(const std::string& s) {
     return res;
 }
 
-void Lookup::load(std::unordered_map<uint64_t, std::vector<char>>& map, std::string& title) {
+void Lookup::load(std::unordered_map<uint64_t, PackedMoves>& map, std::string& title) {
+    std::ifstream file(std::string(DATA_PATH) + "/" + title + ".txt");
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + std::string(DATA_PATH) + "/" + title + ".txt");
+    }
 
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.size() < 20) continue;
+
+        // First 20 chars are the key, padded with 'A', the rest are the moves
+        std::size_t pos = 0;
+        while (pos < 20 && line[pos] == 'A') ++pos;
+
+        const uint64_t key = pos < 20 ? std::stoull(line.substr(pos, 20 - pos)) : 0;
+        map.emplace(key, std::vector<char>(line.begin() + 20, line.end()));
+    }
+
+    file.close();
 }
 
 
-void Lookup::load(std::unordered_map<__int128, std::vector<char>> &map, std::string& title) {
+// One line written by save() for a newHash map, false for a malformed line.
+static bool parseNewHashLine(const std::string &line, __int128 &key, std::vector<char> &moves) {
+    // Ensure line is at least 36 chars (key area); if shorter, skip or handle as error
+    if (line.size() < 36) {
+        return false;
+    }
+
+    // First 36 chars contain padding 'A' and then the decimal string
+    std::string keyField = line.substr(0, 36);
+
+    // find first non-'A' character
+    std::size_t pos = 0;
+    while (pos < keyField.size() && keyField[pos] == 'A') ++pos;
+
+    std::string keyNumStr;
+    if (pos < keyField.size()) {
+        keyNumStr = keyField.substr(pos); // the decimal string for the big int
+    } else {
+        // If entire field is 'A' (unlikely), treat as zero
+        keyNumStr = "0";
+    }
+
+    // Convert to __int128
+    key = strToBigInt(keyNumStr);
+
+    // The remainder of the line (from index 36 to end) are the stored bytes
+    moves.assign(line.begin() + 36, line.end());
+    return true;
+}
+
+void Lookup::load(std::unordered_map<__int128, PackedMoves> &map, std::string& title) {
 
     std::ifstream file(std::string(DATA_PATH) + "/" + title + ".txt");
     if (!file.is_open()) {
@@ -655,43 +1129,40 @@ void Lookup::load(std::unordered_map<__int128, std::vector<char>> &map, std::str
     }
 
     std::string line;
+    __int128 key;
+    std::vector<char> value;
     while (std::getline(file, line)) {
         if (line.empty()) continue;
+        if (!parseNewHashLine(line, key, value)) continue;
 
-        // Ensure line is at least 36 chars (key area); if shorter, skip or handle as error
-        if (line.size() < 36) {
-            // skip malformed line (or throw)
-            continue;
-        }
+        map.emplace(key, value);
+    }
 
-        // First 36 chars contain padding 'A' and then the decimal string
-        std::string keyField = line.substr(0, 36);
+    file.close();
+}
 
-        // find first non-'A' character
-        std::size_t pos = 0;
-        while (pos < keyField.size() && keyField[pos] == 'A') ++pos;
+void Lookup::combineOnDisk(const std::vector<std::string> &titles, const std::string &title, const size_t maxRecordsInMemory) {
+    ExternalTableBuilder<__int128> builder(title, maxRecordsInMemory);
 
-        std::string keyNumStr;
-        if (pos < keyField.size()) {
-            keyNumStr = keyField.substr(pos); // the decimal string for the big int
-        } else {
-            // If entire field is 'A' (unlikely), treat as zero
-            keyNumStr = "0";
+    std::string line;
+    __int128 key;
+    std::vector<char> value;
+    for (const auto &part : titles) {
+        std::ifstream file(std::string(DATA_PATH) + "/" + part + ".txt");
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + std::string(DATA_PATH) + "/" + part + ".txt");
         }
 
-        // Convert to __int128
-        __int128 key = strToBigInt(keyNumStr);
-
-        // The remainder of the line (from index 36 to end) are the stored bytes
-        std::vector<char> value;
-        if (line.size() > 36) {
-            value.assign(line.begin() + 36, line.end());
+        while (std::getline(file, line)) {
+            if (parseNewHashLine(line, key, value)) {
+                builder.add(key, value);
+            }
         }
-
-        map.emplace(key, std::move(value));
+        std::cout << "Added " << part << ", " << builder.numRuns() << " runs on disk.\n";
     }
 
-    file.close();
+    const auto count = builder.finish();
+    std::cout << "Combined table " << title << " has " << count << " keys.\n";
 }
 
 void Lookup::load(std::map<std::array<unsigned int, 4>, std::vector<char>> &map, std::string &title) {
@@ -874,32 +1345,56 @@ uint64_t Lookup::getSize(std::map<std::pair<uint32_t, uint16_t>, uint32_t>& map)
     return total;
 }
 
-void generateSmaller(Lookup &lookup) {
-    for (const auto& [key, vec] : lookup.crossAnd2Corners) {
-        auto newKey = Lookup::hashF(key);
-        auto iterator = lookup.smallerUnorderedCrossAnd2Corners.find(newKey);
-        if (iterator != lookup.smallerUnorderedCrossAnd2Corners.end()) {
-            std::cout << "Something wrong, please kill me\n";
-            std::cin.get();
-        } else {
-            lookup.smallerUnorderedCrossAnd2Corners[Lookup::hashF(key)] = vec;
-        }
+// The table DATA_PATH/title.seq, converted from DATA_PATH/title.txt first if it hasn't been yet.
+static MappedSequenceTable openOrConvert(const std::string &title) {
+    if (!MappedSequenceTable::exists(title)) {
+        std::cout << "Converting " << title << ".txt, later starts map the binary table.\n";
+
+        std::map<std::array<unsigned int, 4>, std::vector<char>> map;
+        std::string path = std::string(DATA_PATH) + "/" + title + ".txt";
+        Lookup::load(map, path);
+        MappedSequenceTable::write(map, title);
     }
+
+    return MappedSequenceTable(title);
 }
 
 Lookup Lookup::loadAllMaps() {
     Lookup lookup;
-    std::string title = DATA_PATH;
 
-    std::string crossTitle = title + "/crossAnd2Corners7D.txt";
-    load(lookup.crossAnd2Corners, crossTitle);
-    generateSmaller(lookup);
+    lookup.crossAnd2CornersTable = openOrConvert("crossAnd2Corners7D");
+    lookup.solveTwoLayerTable = openOrConvert("twoLayer");
+    lookup.solveLastLayerTable = openOrConvert("lastLayer");
+
+    return lookup;
+}
+
+int Lookup::newHashDepth2Corner() {
+    if (newHashDepth2CornerCache >= 0) { return newHashDepth2CornerCache; }
+
+    // The same table the solver picks.
+    size_t longest = 0;
+    if (newHashTable2Corner.isOpen()) {
+        longest = newHashTable2Corner.maxLength();
+    } else if (newHashIndex2Corner.size() > 0) {
+        longest = newHashIndex2Corner.maxLength();
+    } else if (!newHashParents2Corner.empty()) {
+        longest = newHashParents2Corner.maxLength();
+    } else {
+        for (const auto &[key, moves] : newHashMap2Corner) {
+            longest = std::max(longest, moves.size());
+        }
+    }
 
-    std::string twoTitle = title + "/twoLayer.txt";
-    load(lookup.solveTwoLayer, twoTitle);
+    newHashDepth2CornerCache = static_cast<int>(longest);
+    return newHashDepth2CornerCache;
+}
 
-    std::string lastTitle = title + "/lastLayer.txt";
-    load(lookup.solveLastLayer, lastTitle);
+void Lookup::openNewHashTable2Corner(const std::string &title) {
+    newHashTable2Corner = MappedTable<__int128>(title);
+    newHashDepth2CornerCache = -1;
+}
 
-    return lookup;
-}
\ No newline at end of file
+void Lookup::openCoordinateTable2Corner(const std::string &title) {
+    coordinateTable2Corner = MappedTable<uint64_t>(title);
+}
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "RubiksLibrary/MappedTable.hpp"
+#include "RubiksLibrary/FlatIndex.hpp"
+
+std::string tablePath(const std::string &title) {
+    return std::string(DATA_PATH) + "/" + title + ".tbl";
+}
+
+uint64_t alignTo64(const uint64_t offset) {
+    return (offset + 63) / 64 * 64;
+}
+
+// Maps the whole file read-only, returns nullptr when it can't be opened.
+const unsigned char *mapFile(const std::string &path, size_t &fileSize) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return nullptr; }
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    fileSize = static_cast<size_t>(size.QuadPart);
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) { return nullptr; }
+
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    return static_cast<const unsigned char *>(view);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file == -1) { return nullptr; }
+
+    struct stat info{};
+    fstat(file, &info);
+    fileSize = static_cast<size_t>(info.st_size);
+
+    void *view = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (view == MAP_FAILED) { return nullptr; }
+
+    // Probes jump all over the keys, read-ahead would only waste page cache.
+    madvise(view, fileSize, MADV_RANDOM);
+    return static_cast<const unsigned char *>(view);
+#endif
+}
+
+void unmapFile(const unsigned char *data, const size_t fileSize) {
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<unsigned char *>(data), fileSize);
+#endif
+}
+
+template<typename Key>
+MappedTable<Key>::MappedTable(const std::string &title) {
+    const auto path = tablePath(title);
+
+    data = mapFile(path, fileSize);
+    if (data == nullptr) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    MappedTableConst::Header header{};
+    if (fileSize < sizeof(header)) {
+        close();
+        throw std::runtime_error("Table file is truncated: " + path);
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MappedTableConst::magic, sizeof(header.magic)) != 0) {
+        close();
+        throw std::runtime_error("Not a lookup table file: " + path);
+    }
+    if (header.version != MappedTableConst::version || header.keyBytes != sizeof(Key) || header.valueBytes != sizeof(PackedMoves)) {
+        close();
+        throw std::runtime_error("Lookup table " + path + " has version " + std::to_string(header.version) + " and "
+            + std::to_string(header.keyBytes) + " byte keys, expected version " + std::to_string(MappedTableConst::version)
+            + " and " + std::to_string(sizeof(Key)) + " byte keys. Regenerate it.");
+    }
+    if (header.valuesOffset + header.count * header.valueBytes > fileSize || header.keysOffset + header.count * sizeof(Key) > header.valuesOffset) {
+        close();
+        throw std::runtime_error("Table file is truncated: " + path);
+    }
+
+    count = header.count;
+    keys = reinterpret_cast<const Key *>(data + header.keysOffset);
+    values = reinterpret_cast<const PackedMoves *>(data + header.valuesOffset);
+}
+
+template<typename Key>
+MappedTable<Key>::~MappedTable() {
+    close();
+}
+
+template<typename Key>
+MappedTable<Key>::MappedTable(MappedTable &&other) noexcept {
+    *this = std::move(other);
+}
+
+template<typename Key>
+MappedTable<Key> &MappedTable<Key>::operator=(MappedTable &&other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data, other.data);
+        std::swap(fileSize, other.fileSize);
+        std::swap(keys, other.keys);
+        std::swap(values, other.values);
+        std::swap(count, other.count);
+    }
+    return *this;
+}
+
+template<typename Key>
+void MappedTable<Key>::close() {
+    if (data != nullptr) {
+        unmapFile(data, fileSize);
+    }
+    data = nullptr;
+    fileSize = 0;
+    keys = nullptr;
+    values = nullptr;
+    count = 0;
+}
+
+template<typename Key>
+void MappedTable<Key>::write(const std::unordered_map<Key, PackedMoves> &map, const std::string &title) {
+    std::vector<Key> sortedKeys;
+    sortedKeys.reserve(map.size());
+    for (const auto &[key, moves] : map) {
+        sortedKeys.push_back(key);
+    }
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+
+    MappedTableConst::Header header{};
+    std::memcpy(header.magic, MappedTableConst::magic, sizeof(header.magic));
+    header.version = MappedTableConst::version;
+    header.keyBytes = sizeof(Key);
+    header.count = sortedKeys.size();
+    header.valueBytes = sizeof(PackedMoves);
+    header.keysOffset = alignTo64(sizeof(header));
+    header.valuesOffset = alignTo64(header.keysOffset + header.count * sizeof(Key));
+
+    // Written next to the table and renamed over it, so a process that has the old table mapped keeps
+    // reading the old file, and a crash mid-write never leaves a table that passes the header check.
+    const auto path = tablePath(title);
+    std::ofstream file(path + ".tmp", std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path + ".tmp");
+    }
+
+    const std::vector<char> padding(64, 0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(padding.data(), static_cast<std::streamsize>(header.keysOffset - sizeof(header)));
+    file.write(reinterpret_cast<const char *>(sortedKeys.data()), static_cast<std::streamsize>(header.count * sizeof(Key)));
+    file.write(padding.data(), static_cast<std::streamsize>(header.valuesOffset - header.keysOffset - header.count * sizeof(Key)));
+
+    std::vector<PackedMoves> values;
+    values.reserve(sortedKeys.size());
+    for (const auto &key : sortedKeys) {
+        values.push_back(map.at(key));
+    }
+    file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(PackedMoves)));
+
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path + ".tmp");
+    }
+    if (std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + path + ".tmp to " + path);
+    }
+}
+
+template<typename Key>
+bool MappedTable<Key>::contains(const Key key) const {
+    return find(key).has_value();
+}
+
+template<typename Key>
+std::optional<PackedMoves> MappedTable<Key>::find(const Key key) const {
+    const size_t i = FlatIndexSearch::find(keys, count, key);
+    if (i == count) {
+        return std::nullopt;
+    }
+
+    return values[i];
+}
+
+template<typename Key>
+size_t MappedTable<Key>::maxLength() const {
+    size_t longest = 0;
+    for (size_t i = 0; i < count; i++) {
+        longest = std::max(longest, values[i].size());
+    }
+    return longest;
+}
+
+template class MappedTable<__int128>;
+template class MappedTable<uint64_t>;
+
+std::string sequencePath(const std::string &title) {
+    return std::string(DATA_PATH) + "/" + title + ".seq";
+}
+
+MappedSequenceTable::MappedSequenceTable(const std::string &title) {
+    const auto path = sequencePath(title);
+
+    data = mapFile(path, fileSize);
+    if (data == nullptr) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    MappedTableConst::Header header{};
+    if (fileSize < sizeof(header)) {
+        close();
+        throw std::runtime_error("Table file is truncated: " + path);
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MappedTableConst::sequenceMagic, sizeof(header.magic)) != 0) {
+        close();
+        throw std::runtime_error("Not a sequence table file: " + path);
+    }
+    if (header.version != MappedTableConst::sequenceVersion || header.keyBytes != sizeof(Key) || header.valueBytes != 0) {
+        close();
+        throw std::runtime_error("Sequence table " + path + " has version " + std::to_string(header.version)
+            + ", expected version " + std::to_string(MappedTableConst::sequenceVersion) + ". Regenerate it.");
+    }
+
+    const uint64_t movesOffset = alignTo64(header.valuesOffset + (header.count + 1) * sizeof(uint64_t));
+    if (header.keysOffset + header.count * sizeof(Key) > header.valuesOffset || movesOffset > fileSize) {
+        close();
+        throw std::runtime_error("Table file is truncated: " + path);
+    }
+
+    count = header.count;
+    keys = reinterpret_cast<const Key *>(data + header.keysOffset);
+    offsets = reinterpret_cast<const uint64_t *>(data + header.valuesOffset);
+    moves = reinterpret_cast<const char *>(data + movesOffset);
+
+    if (movesOffset + offsets[count] > fileSize) {
+        close();
+        throw std::runtime_error("Table file is truncated: " + path);
+    }
+}
+
+MappedSequenceTable::~MappedSequenceTable() {
+    close();
+}
+
+MappedSequenceTable::MappedSequenceTable(MappedSequenceTable &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedSequenceTable &MappedSequenceTable::operator=(MappedSequenceTable &&other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data, other.data);
+        std::swap(fileSize, other.fileSize);
+        std::swap(keys, other.keys);
+        std::swap(offsets, other.offsets);
+        std::swap(moves, other.moves);
+        std::swap(count, other.count);
+    }
+    return *this;
+}
+
+void MappedSequenceTable::close() {
+    if (data != nullptr) {
+        unmapFile(data, fileSize);
+    }
+    data = nullptr;
+    fileSize = 0;
+    keys = nullptr;
+    offsets = nullptr;
+    moves = nullptr;
+    count = 0;
+}
+
+bool MappedSequenceTable::exists(const std::string &title) {
+    return std::ifstream(sequencePath(title)).is_open();
+}
+
+void MappedSequenceTable::write(const std::map<Key, std::vector<char>> &map, const std::string &title) {
+    MappedTableConst::Header header{};
+    std::memcpy(header.magic, MappedTableConst::sequenceMagic, sizeof(header.magic));
+    header.version = MappedTableConst::sequenceVersion;
+    header.keyBytes = sizeof(Key);
+    header.count = map.size();
+    header.valueBytes = 0;
+    header.keysOffset = alignTo64(sizeof(header));
+    header.valuesOffset = alignTo64(header.keysOffset + header.count * sizeof(Key));
+    const uint64_t movesOffset = alignTo64(header.valuesOffset + (header.count + 1) * sizeof(uint64_t));
+
+    // Written to a temporary name first, so a half written file is never opened as the table.
+    const auto path = sequencePath(title);
+    std::ofstream file(path + ".tmp", std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path + ".tmp");
+    }
+
+    const std::vector<char> padding(64, 0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(padding.data(), static_cast<std::streamsize>(header.keysOffset - sizeof(header)));
+
+    // std::map iterates in key order, which is the order find() searches.
+    for (const auto &[key, sequence] : map) {
+        file.write(reinterpret_cast<const char *>(key.data()), sizeof(Key));
+    }
+    file.write(padding.data(), static_cast<std::streamsize>(header.valuesOffset - header.keysOffset - header.count * sizeof(Key)));
+
+    uint64_t offset = 0;
+    for (const auto &[key, sequence] : map) {
+        file.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        offset += sequence.size();
+    }
+    file.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    file.write(padding.data(), static_cast<std::streamsize>(movesOffset - header.valuesOffset - (header.count + 1) * sizeof(uint64_t)));
+
+    for (const auto &[key, sequence] : map) {
+        file.write(sequence.data(), static_cast<std::streamsize>(sequence.size()));
+    }
+
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path + ".tmp");
+    }
+    if (std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + path + ".tmp to " + path);
+    }
+}
+
+std::optional<std::string_view> MappedSequenceTable::find(const Key &key) const {
+    const Key *it = std::lower_bound(keys, keys + count, key);
+    if (it == keys + count || *it != key) {
+        return std::nullopt;
+    }
+
+    const size_t i = it - keys;
+    return std::string_view(moves + offsets[i], offsets[i + 1] - offsets[i]);
+}
@@ -160,6 +160,103 @@ std::vector<Move> Move::convertVectorCharToMove(const std::vector<char> &moves)
     return out;
 }
 
+std::vector<Move> Move::convertVectorCharToMove(const PackedMoves &moves) {
+    std::vector<Move> out;
+    for (const auto m : moves.unpack()) {
+        out.emplace_back(m);
+    }
+
+    return out;
+}
+
+PackedMoves::PackedMoves(const std::vector<char> &moves) {
+    if (moves.size() > 12) {
+        throw std::runtime_error("PackedMoves holds at most 12 moves, got " + std::to_string(moves.size()) + ".");
+    }
+
+    bits = moves.size();
+    for (size_t i = 0; i < moves.size(); i++) {
+        bits |= static_cast<uint64_t>(moves[i] - 'A') << (4 + 5 * i);
+    }
+}
+
+void PackedMoves::push_back(const char move) {
+    const size_t length = size();
+    if (length == 12) {
+        throw std::runtime_error("PackedMoves holds at most 12 moves.");
+    }
+
+    bits = (bits & ~0xFULL) | (length + 1) | static_cast<uint64_t>(move - 'A') << (4 + 5 * length);
+}
+
+MoveBuffer PackedMoves::unpack() const {
+    MoveBuffer buffer;
+    buffer.length = static_cast<uint8_t>(size());
+    for (size_t i = 0; i < buffer.length; i++) {
+        buffer.moves[i] = (*this)[i];
+    }
+
+    return buffer;
+}
+
+void MoveStack::appendInverse(const PackedMoves &lookupMoves) {
+    for (size_t i = lookupMoves.size(); i-- > 0;) {
+        const int moveIndex = lookupMoves[i] - 'A';
+        push_back(static_cast<char>('A' + moveIndex - moveIndex % 3 + 2 - moveIndex % 3));
+    }
+}
+
+MoveStack MoveStack::combined() const {
+    MoveStack out;
+
+    // Same cases as insertMove, on move indices: face * 3 + rotations - 1.
+    for (const char m : *this) {
+        const int face = (m - 'A') / 3;
+        const int rotations = (m - 'A') % 3 + 1;
+
+        size_t merge = out.length;
+        if (!out.empty() && (out.back() - 'A') / 3 == face) {
+            merge = out.length - 1;
+        } else if (out.length > 1 && (out.back() - 'A') / 3 == RubiksConst::oppositeFaceAll[face] &&
+                   (out[out.length - 2] - 'A') / 3 == face) {
+            merge = out.length - 2;
+        }
+
+        if (merge == out.length) {
+            out.push_back(m);
+            continue;
+        }
+
+        const int merged = ((out[merge] - 'A') % 3 + 1 + rotations) % 4;
+        if (merged != 0) {
+            out.moves[merge] = static_cast<char>('A' + face * 3 + merged - 1);
+            continue;
+        }
+
+        for (size_t i = merge; i + 1 < out.length; i++) {
+            out.moves[i] = out.moves[i + 1];
+        }
+        out.pop_back();
+    }
+
+    return out;
+}
+
+std::vector<Move> MoveStack::toMoves() const {
+    std::vector<Move> out;
+    out.reserve(length);
+    for (const char m : *this) {
+        out.emplace_back(m);
+    }
+
+    return out;
+}
+
+std::vector<char> PackedMoves::toVector() const {
+    const auto buffer = unpack();
+    return {buffer.begin(), buffer.end()};
+}
+
 void Move::printMoves(std::vector<Move> &moves) {
     std::cout << "Moves: ";
 
@@ -0,0 +1,58 @@
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "RubiksLibrary/PackedCube.hpp"
+#include "RubiksLibrary/CpuDispatch.hpp"
+
+PackedCube::PackedCube(): PackedCube(RubiksConst::solvedCube) {}
+
+PackedCube::PackedCube(const std::array<short, 48> &cube) {
+    for (int i = 0; i < 48; i++) {
+        facelets[i] = static_cast<uint8_t>(cube[i]);
+    }
+}
+
+PackedCube::PackedCube(const RubiksCube &cube): PackedCube(cube.cube) {}
+
+std::array<short, 48> PackedCube::toArray() const {
+    std::array<short, 48> cube;
+    for (int i = 0; i < 48; i++) {
+        cube[i] = facelets[i];
+    }
+
+    return cube;
+}
+
+void PackedCube::turn(const Move m) {
+    turnIndex(m.move - 'A');
+}
+
+void PackedCube::turnIndex(const int moveIndex) {
+    CpuDispatch::kernels().turn(facelets.data(), moveIndex);
+}
+
+bool PackedCube::solved() const {
+    static const PackedCube solvedCube;
+    return *this == solvedCube;
+}
+
+bool PackedCube::operator==(const PackedCube &other) const {
+#if defined(__SSE2__)
+    __m128i equal = _mm_set1_epi8(-1);
+    for (int lane = 0; lane < 3; lane++) {
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(&facelets[16 * lane]));
+        const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(&other.facelets[16 * lane]));
+        equal = _mm_and_si128(equal, _mm_cmpeq_epi8(a, b));
+    }
+    return _mm_movemask_epi8(equal) == 0xFFFF;
+#else
+    return std::memcmp(facelets.data(), other.facelets.data(), 48) == 0;
+#endif
+}
+
+__int128 PackedCube::hashNew2Corner() const {
+    return CpuDispatch::kernels().hashNew2Corner(facelets.data());
+}
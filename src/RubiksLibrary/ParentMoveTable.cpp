@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "RubiksLibrary/ParentMoveTable.hpp"
+
+void ParentMoveTable::build(std::vector<Entry> &entries, const uint64_t indexCount) {
+    // Shortest sequence first within an index, so the first entry of every index is the one kept.
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.index != b.index ? a.index < b.index : a.length < b.length;
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.index == b.index;
+    }), entries.end());
+
+    if (entries.size() > UINT32_MAX) {
+        throw std::runtime_error("Too many states for a parent move table.");
+    }
+    if (!entries.empty() && entries.back().index >= indexCount) {
+        throw std::runtime_error("Parent move table index out of range.");
+    }
+
+    const uint64_t buckets = (indexCount >> ParentMoveConst::suffixBits) + 1;
+    bucketStarts.assign(buckets + 1, 0);
+    suffixes.resize(entries.size());
+    parents.assign((entries.size() + ParentMoveConst::movesPerWord - 1) / ParentMoveConst::movesPerWord, 0);
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        bucketStarts[(entries[i].index >> ParentMoveConst::suffixBits) + 1]++;
+        suffixes[i] = static_cast<uint16_t>(entries[i].index);
+        parents[i / ParentMoveConst::movesPerWord] |= static_cast<uint64_t>(entries[i].parent) << (5 * (i % ParentMoveConst::movesPerWord));
+    }
+    for (uint64_t b = 0; b < buckets; b++) {
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+}
+
+size_t ParentMoveTable::position(const uint64_t index) const {
+    const uint64_t bucket = index >> ParentMoveConst::suffixBits;
+    if (bucket + 1 >= bucketStarts.size()) { return suffixes.size(); }
+
+    const auto first = suffixes.begin() + bucketStarts[bucket];
+    const auto last = suffixes.begin() + bucketStarts[bucket + 1];
+    const auto suffix = static_cast<uint16_t>(index);
+    const auto it = std::lower_bound(first, last, suffix);
+    if (it == last || *it != suffix) { return suffixes.size(); }
+    return it - suffixes.begin();
+}
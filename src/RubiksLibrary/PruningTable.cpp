@@ -0,0 +1,197 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "RubiksLibrary/PruningTable.hpp"
+
+void PruningTable::setUp(std::vector<const CoordinateMoveTable *> tables, std::vector<uint64_t> sizes, const uint64_t solved,
+                         const int bitsPerState, std::vector<int> moveIndices) {
+    if (bitsPerState != 4 && bitsPerState != 2) {
+        throw std::runtime_error("A pruning table uses 4 or 2 bits per state.");
+    }
+    if (tables.size() != sizes.size()) {
+        throw std::runtime_error("Every coordinate needs a move table and a size.");
+    }
+    if (moveIndices.empty()) {
+        for (int m = 0; m < 18; m++) {
+            moveIndices.push_back(m);
+        }
+    }
+
+    this->tables = std::move(tables);
+    this->sizes = std::move(sizes);
+    this->moveIndices = std::move(moveIndices);
+    this->solved = solved;
+    bits = bitsPerState;
+    numStates = 1;
+    for (const auto size : this->sizes) {
+        numStates *= size;
+    }
+}
+
+PruningTable PruningTable::generate(std::vector<const CoordinateMoveTable *> tables, std::vector<uint64_t> sizes,
+                                    const uint64_t solved, const int bitsPerState, std::vector<int> moveIndices) {
+    PruningTable table;
+    table.setUp(std::move(tables), std::move(sizes), solved, bitsPerState, std::move(moveIndices));
+
+    // One byte per state while searching, packed at the end.
+    constexpr uint8_t empty = 0xFF;
+    std::vector<uint8_t> distances(table.numStates, empty);
+    distances[solved] = 0;
+
+    uint64_t filled = 1;
+    for (uint8_t d = 0; filled < table.numStates; d++) {
+        uint64_t found = 0;
+
+        // Once most states are found it is cheaper to look for a neighbour at depth d from the states left.
+        if (filled < table.numStates / 2) {
+            for (uint64_t state = 0; state < table.numStates; state++) {
+                if (distances[state] != d) { continue; }
+
+                for (const int m : table.moveIndices) {
+                    const uint64_t next = table.turn(state, m);
+                    if (distances[next] == empty) {
+                        distances[next] = d + 1;
+                        found++;
+                    }
+                }
+            }
+        } else {
+            for (uint64_t state = 0; state < table.numStates; state++) {
+                if (distances[state] != empty) { continue; }
+
+                for (const int m : table.moveIndices) {
+                    if (distances[table.turn(state, m)] == d) {
+                        distances[state] = d + 1;
+                        found++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // The rest can't be reached, like slot edges on top of the cross edges.
+        if (found == 0) { break; }
+        if (table.bits == 4 && d + 1 > 14) {
+            throw std::runtime_error("Distance too large for 4 bits per state.");
+        }
+
+        filled += found;
+        std::cout << "Depth " << d + 1 << ": " << found << " states.\n";
+    }
+
+    table.data.assign((table.numStates * table.bits + 7) / 8, 0);
+    const uint8_t unreachedValue = (1 << table.bits) - 1;
+    for (uint64_t state = 0; state < table.numStates; state++) {
+        if (distances[state] == empty) {
+            table.set(state, unreachedValue);
+        } else {
+            table.set(state, table.bits == 4 ? distances[state] : distances[state] % 3);
+        }
+    }
+
+    return table;
+}
+
+PruningTable PruningTable::loadOrGenerate(std::vector<const CoordinateMoveTable *> tables, std::vector<uint64_t> sizes,
+                                          const uint64_t solved, const int bitsPerState, const std::string &title,
+                                          std::vector<int> moveIndices) {
+    PruningTable table;
+    table.setUp(tables, sizes, solved, bitsPerState, moveIndices);
+    if (table.load(title)) {
+        return table;
+    }
+
+    std::cout << "Generating pruning table " << title << ".\n";
+    table = generate(std::move(tables), std::move(sizes), solved, bitsPerState, std::move(moveIndices));
+    table.save(title);
+    return table;
+}
+
+void PruningTable::save(const std::string &title) const {
+    std::ofstream file(std::string(DATA_PATH) + "/" + title + ".bin", std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + std::string(DATA_PATH) + "/" + title + ".bin");
+    }
+
+    const uint32_t bitsOut = bits;
+    file.write(reinterpret_cast<const char *>(&numStates), sizeof(numStates));
+    file.write(reinterpret_cast<const char *>(&bitsOut), sizeof(bitsOut));
+    file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+bool PruningTable::load(const std::string &title) {
+    std::ifstream file(std::string(DATA_PATH) + "/" + title + ".bin", std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    uint64_t size = 0;
+    uint32_t bitsIn = 0;
+    file.read(reinterpret_cast<char *>(&size), sizeof(size));
+    file.read(reinterpret_cast<char *>(&bitsIn), sizeof(bitsIn));
+    if (!file || size != numStates || bitsIn != static_cast<uint32_t>(bits)) {
+        return false;
+    }
+
+    data.resize((numStates * bits + 7) / 8);
+    file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+uint64_t PruningTable::turn(uint64_t state, const int moveIndex) const {
+    uint64_t out = 0;
+    uint64_t factor = 1;
+    for (size_t i = sizes.size(); i-- > 0;) {
+        const auto coordinate = static_cast<uint32_t>(state % sizes[i]);
+        state /= sizes[i];
+
+        out += tables[i]->turn(coordinate, moveIndex) * factor;
+        factor *= sizes[i];
+    }
+    return out;
+}
+
+int PruningTable::distance(uint64_t state) const {
+    const uint8_t value = get(state);
+    if (value == (1 << bits) - 1) { return unreached; }
+    if (bits == 4) { return value; }
+
+    // Step to a neighbour one move closer until solved.
+    int out = 0;
+    uint8_t current = value;
+    while (state != solved) {
+        const uint8_t closer = (current + 2) % 3;
+        for (const int m : moveIndices) {
+            const uint64_t next = turn(state, m);
+            if (get(next) == closer) {
+                state = next;
+                break;
+            }
+        }
+        current = closer;
+        out++;
+    }
+    return out;
+}
+
+int PruningTable::distance(const uint64_t state, const int neighbourDistance) const {
+    const uint8_t value = get(state);
+    if (value == (1 << bits) - 1) { return unreached; }
+    if (bits == 4) { return value; }
+
+    for (int d = neighbourDistance - 1; d <= neighbourDistance + 1; d++) {
+        if (d >= 0 && d % 3 == value) { return d; }
+    }
+    return unreached;
+}
+
+void PruningTable::set(const uint64_t state, const uint8_t value) {
+    const int shift = static_cast<int>(state % (8 / bits)) * bits;
+    uint8_t &byte = data[state * bits / 8];
+    byte = static_cast<uint8_t>((byte & ~(((1 << bits) - 1) << shift)) | (value << shift));
+}
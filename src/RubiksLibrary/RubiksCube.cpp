@@ -15,6 +15,8 @@ std::array<Move, 18> RubiksConst::everyMove = {
         Move('M'), Move('N'), Move('O'), Move('P'), Move('Q'), Move('R')
 };
 
+TurnEngine RubiksCube::turnEngine = PermutationTable;
+
 std::array<short, 48> RubiksCube::getCubeFromHash(__int128 hash) {
     auto physical = RubiksConst::physicalPieces;
     auto colors = RubiksConst::colors;
@@ -950,8 +952,46 @@ void RubiksCube::raiseSolved() {
     }
 }
 
-void RubiksCube::turn(Move m) {
-    switch (m.move) {
+void RubiksCube::turn(const Move m) {
+    turnIndex(m.move - 'A');
+}
+
+void RubiksCube::turn(const char m) {
+    if (m < 'A' || m > 'R') {
+        std::string error = "Invalid char '";
+        error.push_back(m);
+        error = error + "' for turning the cube";
+        throw std::runtime_error(error);
+    }
+
+    turnIndex(m - 'A');
+}
+
+void RubiksCube::turn(const int face, const int rotations) {
+    turnIndex(face * 3 + rotations - 1);
+}
+
+void RubiksCube::turnIndex(const int moveIndex) {
+    // turn(Move) and turn(face, rotations) come through here unchecked.
+    if (moveIndex < 0 || moveIndex >= 18) {
+        throw std::runtime_error("Invalid move index " + std::to_string(moveIndex) + " for turning the cube");
+    }
+
+    if (turnEngine == HandWritten) {
+        turnHandWritten(MoveConst::moves[moveIndex]);
+        return;
+    }
+
+    // Gather from a snapshot so the 20 moved facelets can be written in any order.
+    const auto &moved = RubiksConst::movedFacelets[moveIndex];
+    const std::array<short, 48> previous = cube;
+    for (int k = 0; k < 20; k++) {
+        cube[moved.destination[k]] = previous[moved.source[k]];
+    }
+}
+
+void RubiksCube::turnHandWritten(const char m) {
+    switch (m) {
         case 'A':
         {
             turnWhite1();
@@ -1044,15 +1084,6 @@ void RubiksCube::turn(Move m) {
     }
 }
 
-void RubiksCube::turn(char m) {
-    Move move = Move(m);
-    turn(move);
-}
-
-void RubiksCube::turn(int face, int rotations) {
-    turn(Move(face, rotations));
-}
-
 void RubiksCube::turnWhite(int rotations) {
     switch (rotations) {
         case 1: {
@@ -2,21 +2,30 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <chrono>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "RubiksLibrary/Solver.hpp"
 #include "RubiksLibrary/Lookup.hpp"
+#include "RubiksLibrary/TwoPhase.hpp"
 
 class RubiksSolver {
 public:
 	RubiksSolver();
 	~RubiksSolver();
 
-	std::vector<char> solve(const std::vector<int> &input);
+	// engine is "lookup" for Solver::solveFullCube or "twoPhase" for TwoPhaseSolver. A positive timeLimitMs
+	// makes either engine return the best solution it has after that many milliseconds, and an empty one when
+	// it has none yet. workers is the number of threads the lookup engine searches with.
+	std::vector<char> solve(const std::vector<int> &input, const std::string &engine = "lookup", int timeLimitMs = 0,
+	                        unsigned workers = 1);
 
 private:
 	Lookup lookup;
+	// Kept between calls, so a multi-threaded solve reuses its threads.
+	Solver solver;
 };
 
 
@@ -30,15 +39,34 @@ RubiksSolver::~RubiksSolver() {
 	std::cout << "Destruction complete" << "\n";
 }
 
-std::vector<char> RubiksSolver::solve(const std::vector<int>& input) {
+std::vector<char> RubiksSolver::solve(const std::vector<int>& input, const std::string &engine, const int timeLimitMs,
+                                     const unsigned workers) {
 	RubiksCube cube;
 	for (int i = 0; i < 48; i++) {
 	    cube.cube[i] = input[i];
 	}
 
-	Solver solver;
+	auto deadline = std::chrono::steady_clock::time_point::max();
+	if (timeLimitMs > 0) {
+		deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeLimitMs);
+	}
+
+	std::vector<Move> solvingMoves;
+	if (engine == "lookup") {
+		SolveOptions options;
+		options.parallel.workers = workers;
+		if (timeLimitMs > 0) {
+			options.mode = SolveMode::anytime;
+			options.deadline = deadline;
+		}
+
+		solvingMoves = solver.solveFullCube(cube, lookup, options);
+	} else if (engine == "twoPhase") {
+		solvingMoves = TwoPhaseSolver::solve(cube, 21, deadline);
+	} else {
+		throw std::runtime_error("Unknown engine: " + engine);
+	}
 
-	auto solvingMoves = solver.solveFullCube(cube, lookup);
 	auto solvingMovesChar = Move::convertVectorMoveToChar(solvingMoves);
 	return solvingMovesChar;
 }
@@ -46,5 +74,6 @@ std::vector<char> RubiksSolver::solve(const std::vector<int>& input) {
 PYBIND11_MODULE(RubiksSolver, m) {
 	pybind11::class_<RubiksSolver>(m, "RubiksSolver")
 		.def(pybind11::init<>())
-		.def("solve", &RubiksSolver::solve);
+		.def("solve", &RubiksSolver::solve, pybind11::arg("input"), pybind11::arg("engine") = "lookup",
+		     pybind11::arg("timeLimitMs") = 0, pybind11::arg("workers") = 1);
 }
\ No newline at end of file
@@ -1,28 +1,141 @@
 
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <optional>
 
 #include "RubiksLibrary/Solver.hpp"
 #include "RubiksLibrary/Move.hpp"
+#include "RubiksLibrary/WorkStealing.hpp"
 
-std::vector<Move> Solver::solveFullCube(RubiksCube &cube, Lookup &lookup, const int depth, const bool twoCorner) {
+// The executor for parallel.workers threads, none for a single worker. Made once per solve and handed to every
+// searchSplit, so the deepening passes share the threads.
+std::unique_ptr<WorkStealingExecutor> makeExecutor(const ParallelSearch &parallel) {
+	if (parallel.workers <= 1) {return nullptr;}
+	return std::make_unique<WorkStealingExecutor>(parallel.workers);
+}
 
-	std::array<short, 48> shuffleCubeCopy;
-	for (int i = 0; i < 48; i++) {
-		shuffleCubeCopy[i] = cube.cube[i];
+// Runs search(conditions, depth) on the workers of executor, or on the calling thread without one. Conditions
+// is one of the {cube, lookup, moves, solutions, hash} structs. A subtree task splits into its children while
+// it is less than parallel.splitDepth below the root and the executor is short of work; each task searches
+// with its own copy of the cube and move stack.
+template<typename Conditions, typename Search>
+void searchSplit(Conditions &conditions, const int depth, const ParallelSearch &parallel, WorkStealingExecutor *pool, Search search) {
+	if (pool == nullptr) {
+		search(conditions, depth);
+		return;
 	}
 
+	auto &executor = *pool;
+	const size_t rootSize = conditions.moves.size();
+
+	// Keyed by the moves below the root. A prefix sorts before its extensions and the moves are tried in
+	// alphabetical order, so the map iterates in the order the serial search finds the solutions.
+	std::mutex resultsMutex;
+	std::map<std::string, std::vector<Solution>> results;
+
+	std::function<void(std::vector<Move>, int)> searchTask = [&](std::vector<Move> prefix, const int remaining) {
+		auto cube = conditions.cube;
+		std::string key;
+		for (size_t i = rootSize; i < prefix.size(); i++) {
+			cube.turn(prefix[i]);
+			key += prefix[i].move;
+		}
+
+		const bool split = remaining > 0 && static_cast<int>(key.size()) < parallel.splitDepth && executor.needsWork();
+
+		std::vector<Solution> found;
+		Conditions local = {cube, conditions.lookup, prefix, found, conditions.hash};
+		search(local, split ? 0 : remaining);
+
+		if (split) {
+			const auto size = prefix.size();
+			const Move prevMove = size > 0 ? prefix[size - 1] : Move{7, 7};
+			const Move doublePrevMove = size > 1 ? prefix[size - 2] : Move{7, 7};
+
+			for (Move m : RubiksConst::everyMove) {
+				if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+				std::vector<Move> child = prefix;
+				child.push_back(m);
+				executor.spawn([&searchTask, child, remaining]() {searchTask(child, remaining - 1);});
+			}
+		}
+
+		if (!found.empty()) {
+			std::lock_guard lock(resultsMutex);
+			results[key] = std::move(found);
+		}
+	};
+
+	executor.spawn([&]() {searchTask(conditions.moves, depth);});
+	executor.run();
+
+	for (auto &[key, found] : results) {
+		conditions.solutions.insert(conditions.solutions.end(), found.begin(), found.end());
+	}
+}
+
+// Iterative deepening: search(conditions, depth, leavesOnly) from depth until there is a solution, or until
+// stopped() says to give up. A pass that finds nothing has probed every node up to its depth, so the next pass
+// only probes the new leaves.
+template<typename Conditions, typename Search, typename Stopped>
+void searchDeepening(Conditions &conditions, const int depth, Search search, Stopped stopped) {
+	search(conditions, depth, false);
+
+	for (int d = depth + 1; conditions.solutions.empty() && !stopped(); d++) {
+		search(conditions, d, true);
+	}
+}
+
+template<typename Conditions, typename Search>
+void searchDeepening(Conditions &conditions, const int depth, Search search) {
+	searchDeepening(conditions, depth, search, []() {return false;});
+}
+
+std::vector<Move> Solver::solveFullCube(RubiksCube &cube, Lookup &lookup, const int depth, const bool twoCorner) {
+	return solveFullCube(cube, lookup, SolveOptions{}, depth, twoCorner);
+}
+
+std::vector<Move> Solver::solveFullCube(RubiksCube &cube, Lookup &lookup, const SolveOptions &options, const int depth, const bool twoCorner) {
+	std::array<short, 48> shuffleCubeCopy = cube.cube;
+
+	searchMode = options.mode;
+	searchParallel = options.parallel;
+	searchDeadline = options.deadline;
+	searchStopped = false;
+
 	std::vector<Solution> solutions;
-	if (twoCorner) {
+	if (twoCorner && options.arena) {
+		findCrossAnd2CornersInArena(cube, lookup, searchArena, depth, options.deadline);
+		for (const auto &candidate : searchArena.solutions) {
+			Solution solution;
+			solution.crossMoves = candidate.toMoves();
+			solutions.push_back(solution);
+		}
+	} else if (twoCorner) {
 		solutions = findCrossAnd2Corners(cube, lookup, depth);
 	} else {
 		solutions = findCrossAnd3Corners(cube, lookup, depth);
 	}
 
-	for (auto &solution : solutions) {
+	searchMode = SolveMode::best;
+	searchParallel = {};
+	searchDeadline = std::chrono::steady_clock::time_point::max();
+	searchStopped = false;
+
+	// With a time limit the shortest starts are finished first.
+	if (options.mode != SolveMode::best) {
+		std::stable_sort(solutions.begin(), solutions.end(), [](const Solution &a, const Solution &b) {
+			return a.crossMoves.size() < b.crossMoves.size();
+		});
+	}
+
+	std::vector<Move> out;
+	int fewestMoves = 100;
+	for (const auto &solution : solutions) {
 		RubiksCube cubeSolutions;
-		for (int i = 0; i < 48; i++) {
-			cubeSolutions.cube[i] = shuffleCubeCopy[i];
-		}
+		cubeSolutions.cube = shuffleCubeCopy;
 
 		for (auto &m : solution.crossMoves) {
 			cubeSolutions.turn(m);
@@ -30,15 +143,12 @@ std::vector<Move> Solver::solveFullCube(RubiksCube &cube, Lookup &lookup, const
 
 		cubeSolutions.raiseCross();
 		cubeSolutions.raiseTwoCorners();
-	}
-
 
-	findAndTestSolutionsFirstTwoLayers(shuffleCubeCopy, lookup, solutions);
-	findAndTestSolutionsLastLayer(shuffleCubeCopy, lookup, solutions);
+		std::vector<Solution> finished = {solution};
+		findAndTestSolutionsFirstTwoLayers(shuffleCubeCopy, lookup, finished);
+		findAndTestSolutionsLastLayer(shuffleCubeCopy, lookup, finished);
 
-	std::vector<Move> out;
-	int fewestMoves = 100;
-	for (const auto &sol : solutions) {
+		const auto &sol = finished.front();
 		std::vector allMoves = {sol.crossMoves, sol.twoLayerMoves, sol.lastLayerMoves};
 		auto combinedMoves = Move::combineMoves(allMoves);
 
@@ -46,16 +156,46 @@ std::vector<Move> Solver::solveFullCube(RubiksCube &cube, Lookup &lookup, const
 		if (num < fewestMoves) {
 			fewestMoves = num;
 			out = combinedMoves;
+
+			if (options.onImprovement) {options.onImprovement(out);}
 		}
+
+		if (options.mode == SolveMode::firstHit) {break;}
+		if (std::chrono::steady_clock::now() >= options.deadline) {break;}
 	}
 
 	return out;
 }
 
-std::vector<Move> Solver::solveUpTo2CornersUsingNewHash(RubiksCube& cube, Lookup& lookup, int depth) {
+WorkStealingExecutor *Solver::searchExecutor() {
+	if (searchParallel.workers <= 1) {return nullptr;}
+
+	// Kept between solves, the threads are only replaced when the number of workers changes.
+	if (!executor || executor->workers() != searchParallel.workers) {
+		executor = makeExecutor(searchParallel);
+	}
+	return executor.get();
+}
+
+bool Solver::stopSearch(const int depth) {
+	if (searchStopped.load(std::memory_order_relaxed)) {return true;}
+
+	// The clock is only read above the last two levels, which hold nearly all the nodes.
+	if (depth < 2 || searchDeadline == std::chrono::steady_clock::time_point::max()) {return false;}
+	if (std::chrono::steady_clock::now() < searchDeadline) {return false;}
+
+	searchStopped = true;
+	return true;
+}
+
+void Solver::foundSolution() {
+	if (searchMode == SolveMode::firstHit) {searchStopped = true;}
+}
+
+std::vector<Move> Solver::solveUpTo2CornersUsingNewHash(RubiksCube& cube, Lookup& lookup, int depth, const ParallelSearch &parallel) {
 	std::array<short, 48> shuffleCubeCopy = cube.cube;
 
-	std::vector<Solution> solutions = findCrossAnd2CornersUsingNewHash(cube, lookup, depth);
+	std::vector<Solution> solutions = findCrossAnd2CornersUsingNewHash(cube, lookup, depth, parallel);
 
 	for (auto &solution : solutions) {
 		RubiksCube cubeSolutions;
@@ -85,33 +225,392 @@ std::vector<Move> Solver::solveUpTo2CornersUsingNewHash(RubiksCube& cube, Lookup
 	return out;
 }
 
-std::vector<Solution> Solver::findCrossAnd2CornersUsingNewHash(RubiksCube &cube, Lookup &lookup, int depth) {
+std::vector<Solution> Solver::findCrossAnd2CornersUsingNewHash(RubiksCube &cube, Lookup &lookup, int depth, const ParallelSearch &parallel) {
 	if ((cube.numCornerSolved() == 3) && cube.solvedWhiteCross()) {return {};}
 
 	std::vector<Move> moves;
 	std::vector<Solution> solutions;
+	HashedCube hashed(cube);
+	const auto executor = makeExecutor(parallel);
+
+	auto search = [&](const auto &table) {
+		SearchConditionsNewHash searchConditions = {hashed, table, moves, solutions, TwoCornerNewHash};
+		searchDeepening(searchConditions, depth, [&parallel, &executor](auto &conditions, const int d, const bool leavesOnly) {
+			if (leavesOnly) {
+				std::cout << "\n";
+				std::cout << "Had to increase depth to " << d << ".\n";
+			}
+			searchSplit(conditions, d, parallel, executor.get(), [leavesOnly](auto &split, int splitDepth) {searchMovesNewHash(split, splitDepth, leavesOnly);});
+		});
+	};
+
+	if (lookup.newHashTable2Corner.isOpen()) {
+		search(lookup.newHashTable2Corner);
+	} else if (lookup.newHashIndex2Corner.size() > 0) {
+		search(lookup.newHashIndex2Corner);
+	} else if (!lookup.newHashParents2Corner.empty()) {
+		search(lookup.newHashParents2Corner);
+	} else {
+		search(lookup.newHashMap2Corner);
+	}
+
+	return solutions;
+}
+
+// The moves stored for key in an unordered_map, or in a MappedTable/FlatIndex.
+template<typename Key>
+std::optional<PackedMoves> findLookupMoves(const std::unordered_map<Key, PackedMoves> &lookup, const Key key) {
+	const auto it = lookup.find(key);
+	if (it == lookup.end()) {return std::nullopt;}
+	return it->second;
+}
+
+template<typename Table, typename Key>
+std::optional<PackedMoves> findLookupMoves(const Table &lookup, const Key key) {
+	return lookup.find(key);
+}
+
+template<typename Table>
+std::optional<PackedMoves> findNewHashMoves(const Table &lookup, const HashedCube &cube) {
+	return findLookupMoves(lookup, cube.hash);
+}
+
+// Only the last moves are stored, so a hit walks the table back to the solved state with a copy of the cube.
+std::optional<PackedMoves> findNewHashMoves(const ParentMoveTable &lookup, const HashedCube &cube) {
+	const uint64_t index = cube.denseIndex();
+	if (!lookup.contains(index)) {return std::nullopt;}
 
-	SearchConditionsNewHash searchConditions = {cube, lookup.newHashMap2Corner, moves, solutions, TwoCornerNewHash};
-	searchMovesNewHash(searchConditions, depth);
+	HashedCube walked = cube;
+	return lookup.reconstruct(index, [&walked](const int moveIndex) {
+		walked.turnIndex(moveIndex);
+		return walked.denseIndex();
+	});
+}
+
+template<typename Table>
+void Solver::searchMovesNewHash(SearchConditionsNewHash<Table>& searchConditions, int depth, const bool leavesOnly) {
+	auto &cube = searchConditions.cube;
+	auto &lookup = searchConditions.lookup;
+
+	const auto lookupChars = (leavesOnly && depth > 0) ? std::nullopt : findNewHashMoves(lookup, cube);
+	if (lookupChars) {
+		const auto lookupMoves = Move::convertVectorCharToMove(*lookupChars);
+		const auto solution = Move::combineMovesWithLookupMoves(searchConditions.moves, lookupMoves);
+
+		Solution newSol;
+		newSol.crossMoves = solution;
+		searchConditions.solutions.push_back(newSol);
+	}
+
+	if (depth == 0) {return;}
+
+	auto &moves = searchConditions.moves;
+	auto size = moves.size();
+
+	Move prevMove {7, 7};
+	Move doublePrevMove {7, 7};
 
-	if (solutions.empty()) {
-		std::cout << "\n";
-		std::cout << "Had to increase depth to " << depth + 1 << ".\n";
-		return findCrossAnd2CornersUsingNewHash(cube, lookup, depth + 1);
-		// throw std::runtime_error("No solution found for this depth-limit and lookup combo.");
+	if (size > 1) {
+		prevMove = moves[size - 1];
+		doublePrevMove = moves[size - 2];
+	} else if (size > 0) {
+		prevMove = moves[size - 1];
+	}
+
+	for (Move m : RubiksConst::everyMove)
+	{
+		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+		// Restoring a copy is cheaper than turning back and recomputing the hash.
+		const HashedCube previous = cube;
+		moves.push_back(m);
+		cube.turn(m);
+
+		searchMovesNewHash(searchConditions, depth - 1, leavesOnly);
+
+		cube = previous;
+		moves.pop_back();
+	}
+}
+
+// findNewHashMoves for count cubes. Only the FlatIndex has a batched find, other tables are probed one by one.
+template<typename Table>
+void findNewHashMovesBatch(const Table &lookup, const HashedCube *cubes, const size_t count, std::optional<PackedMoves> *out) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = findNewHashMoves(lookup, cubes[i]);
+	}
+}
+
+void findNewHashMovesBatch(const FlatIndex<__int128> &lookup, const HashedCube *cubes, const size_t count, std::optional<PackedMoves> *out) {
+	std::array<__int128, 18> keys;
+	for (size_t i = 0; i < count; i++) {
+		keys[i] = cubes[i].hash;
+	}
+	lookup.findBatch(keys.data(), count, out);
+}
+
+std::vector<Move> Solver::solveUpTo2CornersMeetInTheMiddle(RubiksCube &cube, Lookup &lookup, const int maxDepth, const ParallelSearch &parallel) {
+	const std::vector<Solution> solutions = findCrossAnd2CornersMeetInTheMiddle(cube, lookup, maxDepth, parallel);
+
+	std::vector<Move> out;
+	int fewestMoves = 100;
+	for (const auto &sol : solutions) {
+		std::vector allMoves = {sol.crossMoves};
+		auto combinedMoves = Move::combineMoves(allMoves);
+
+		const int num = combinedMoves.size();
+		if (num < fewestMoves) {
+			fewestMoves = num;
+			out = combinedMoves;
+		}
+	}
+
+	return out;
+}
+
+std::vector<Solution> Solver::findCrossAnd2CornersMeetInTheMiddle(RubiksCube &cube, Lookup &lookup, const int maxDepth,
+                                                                  const ParallelSearch &parallel) {
+	if ((cube.numCornerSolved() == 3) && cube.solvedWhiteCross()) {return {};}
+
+	const int tableDepth = lookup.newHashDepth2Corner();
+	if (tableDepth == 0) {
+		throw std::runtime_error("No newHash 2 corner table loaded.");
+	}
+
+	// No state closer than the lower bound is solved, so no forward node within lowerBound - tableDepth moves
+	// can be in the table.
+	int forwardDepth = 0;
+	if (lookup.crossCornersDistance.isOpen() && lookup.crossSlotEdgesDistance.isOpen()) {
+		const CrossAnd2CornersCoordinates coordinates{CubieCube(cube)};
+		forwardDepth = std::max(0, lookup.distance2Corner(coordinates) - tableDepth);
+	}
+
+	std::vector<Move> moves;
+	moves.reserve(maxDepth);
+	std::vector<Solution> solutions;
+	HashedCube hashed(cube);
+	const auto executor = makeExecutor(parallel);
+
+	// The first forward depth with a hit meets every shortest solution: the scramble is at most tableDepth moves
+	// from a node on it at that depth.
+	auto search = [&](const auto &table) {
+		SearchConditionsNewHash searchConditions = {hashed, table, moves, solutions, TwoCornerNewHash};
+		for (; forwardDepth <= maxDepth && solutions.empty(); forwardDepth++) {
+			searchSplit(searchConditions, forwardDepth, parallel, executor.get(), [](auto &conditions, int d) {searchMovesMeetInTheMiddle(conditions, d);});
+		}
+	};
+
+	if (lookup.newHashTable2Corner.isOpen()) {
+		search(lookup.newHashTable2Corner);
+	} else if (lookup.newHashIndex2Corner.size() > 0) {
+		search(lookup.newHashIndex2Corner);
+	} else if (!lookup.newHashParents2Corner.empty()) {
+		search(lookup.newHashParents2Corner);
 	} else {
-		return solutions;
+		search(lookup.newHashMap2Corner);
 	}
+
+	return solutions;
 }
 
-void Solver::searchMovesNewHash(SearchConditionsNewHash& searchConditions, int depth) {
+template<typename Table>
+void Solver::searchMovesMeetInTheMiddle(SearchConditionsNewHash<Table> &searchConditions, const int forwardDepth) {
 	auto &cube = searchConditions.cube;
-	auto &lookup = searchConditions.lookup;
+	auto &moves = searchConditions.moves;
 
-	const auto hash = cube.hashNew2Corner();
-	if (lookup.contains(hash)) {
-		const auto lookupChars = lookup[hash];
+	const auto addSolution = [&searchConditions](const PackedMoves &lookupChars) {
 		const auto lookupMoves = Move::convertVectorCharToMove(lookupChars);
+
+		Solution newSol;
+		newSol.crossMoves = Move::combineMovesWithLookupMoves(searchConditions.moves, lookupMoves);
+		searchConditions.solutions.push_back(newSol);
+	};
+
+	// Only reached at the root, or where searchSplit hands a subtree to another task.
+	if (forwardDepth == 0) {
+		const auto lookupChars = findNewHashMoves(searchConditions.lookup, cube);
+		if (lookupChars) {addSolution(*lookupChars);}
+		return;
+	}
+
+	const auto size = moves.size();
+	const Move prevMove = size > 0 ? moves[size - 1] : Move{7, 7};
+	const Move doublePrevMove = size > 1 ? moves[size - 2] : Move{7, 7};
+
+	if (forwardDepth == 1) {
+		std::array<HashedCube, 18> children;
+		std::array<int, 18> childMoves;
+		size_t count = 0;
+
+		for (Move m : RubiksConst::everyMove) {
+			if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+			children[count] = cube;
+			children[count].turn(m);
+			childMoves[count++] = m.move - 'A';
+		}
+
+		std::array<std::optional<PackedMoves>, 18> found;
+		findNewHashMovesBatch(searchConditions.lookup, children.data(), count, found.data());
+
+		for (size_t i = 0; i < count; i++) {
+			if (!found[i]) { continue;}
+
+			moves.push_back(RubiksConst::everyMove[childMoves[i]]);
+			addSolution(*found[i]);
+			moves.pop_back();
+		}
+		return;
+	}
+
+	for (Move m : RubiksConst::everyMove)
+	{
+		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+		const HashedCube previous = cube;
+		moves.push_back(m);
+		cube.turn(m);
+
+		searchMovesMeetInTheMiddle(searchConditions, forwardDepth - 1);
+
+		cube = previous;
+		moves.pop_back();
+	}
+}
+
+MoveStack Solver::solveUpTo2CornersInArena(RubiksCube &cube, const Lookup &lookup, SearchArena &arena, const int depth) {
+	findCrossAnd2CornersInArena(cube, lookup, arena, depth);
+
+	MoveStack out;
+	size_t fewestMoves = 100;
+	for (const auto &solution : arena.solutions) {
+		const MoveStack combinedMoves = solution.combined();
+		if (combinedMoves.size() < fewestMoves) {
+			fewestMoves = combinedMoves.size();
+			out = combinedMoves;
+		}
+	}
+
+	return out;
+}
+
+void Solver::findCrossAnd2CornersInArena(RubiksCube &cube, const Lookup &lookup, SearchArena &arena, const int depth,
+                                         const std::chrono::steady_clock::time_point deadline) {
+	arena.solutions.clear();
+	if ((cube.numCornerSolved() == 3) && cube.solvedWhiteCross()) {return;}
+
+	MoveStack moves;
+	HashedCube hashed(cube);
+
+	auto search = [&](const auto &table) {
+		SearchConditionsStack searchConditions = {hashed, table, moves, arena.solutions};
+		searchDeepening(searchConditions, depth, [](auto &conditions, const int d, const bool leavesOnly) {
+			searchMovesStack(conditions, d, leavesOnly);
+		}, [deadline]() {return std::chrono::steady_clock::now() >= deadline;});
+	};
+
+	if (lookup.newHashTable2Corner.isOpen()) {
+		search(lookup.newHashTable2Corner);
+	} else if (lookup.newHashIndex2Corner.size() > 0) {
+		search(lookup.newHashIndex2Corner);
+	} else if (!lookup.newHashParents2Corner.empty()) {
+		search(lookup.newHashParents2Corner);
+	} else if (!lookup.newHashMap2Corner.empty()) {
+		search(lookup.newHashMap2Corner);
+	} else {
+		// Deepening on an empty table would never stop.
+		throw std::runtime_error("No newHash 2 corner table loaded.");
+	}
+}
+
+template<typename Table>
+void Solver::searchMovesStack(SearchConditionsStack<Table> &searchConditions, const int depth, const bool leavesOnly) {
+	auto &cube = searchConditions.cube;
+	auto &moves = searchConditions.moves;
+
+	if (!leavesOnly || depth == 0) {
+		const auto lookupChars = findNewHashMoves(searchConditions.lookup, cube);
+		if (lookupChars) {
+			MoveStack solution = moves;
+			solution.appendInverse(*lookupChars);
+			searchConditions.solutions.push_back(solution);
+		}
+	}
+
+	if (depth == 0) {return;}
+
+	const Move prevMove = moves.size() > 0 ? RubiksConst::everyMove[moves.back() - 'A'] : Move{7, 7};
+	const Move doublePrevMove = moves.size() > 1 ? RubiksConst::everyMove[moves[moves.size() - 2] - 'A'] : Move{7, 7};
+
+	for (Move m : RubiksConst::everyMove)
+	{
+		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+		const HashedCube previous = cube;
+		moves.push_back(m.move);
+		cube.turn(m);
+
+		searchMovesStack(searchConditions, depth - 1, leavesOnly);
+
+		cube = previous;
+		moves.pop_back();
+	}
+}
+
+std::vector<Move> Solver::solveUpTo2CornersUsingCoordinates(RubiksCube& cube, Lookup& lookup, int depth) {
+	const std::vector<Solution> solutions = findCrossAnd2CornersUsingCoordinates(cube, lookup, depth);
+
+	std::vector<Move> out;
+	int fewestMoves = 100;
+	for (const auto &sol : solutions) {
+		std::vector allMoves = {sol.crossMoves};
+		auto combinedMoves = Move::combineMoves(allMoves);
+
+		const int num = combinedMoves.size();
+		if (num < fewestMoves) {
+			fewestMoves = num;
+			out = combinedMoves;
+		}
+	}
+
+	return out;
+}
+
+std::vector<Solution> Solver::findCrossAnd2CornersUsingCoordinates(RubiksCube &cube, Lookup &lookup, int depth) {
+	if ((cube.numCornerSolved() == 3) && cube.solvedWhiteCross()) {return {};}
+
+	std::vector<Move> moves;
+	std::vector<Solution> solutions;
+
+	const CrossAnd2CornersCoordinates coordinates{CubieCube(cube)};
+	auto search = [&](const auto &table) {
+		SearchConditionsCoordinates searchConditions = {CrossAnd2CornersCoordinates::moveTables(), table, moves, solutions};
+		searchDeepening(searchConditions, depth, [&coordinates](auto &conditions, const int d, const bool leavesOnly) {
+			if (leavesOnly) {
+				std::cout << "\n";
+				std::cout << "Had to increase depth to " << d << ".\n";
+			}
+			searchMovesCoordinates(conditions, coordinates, d, leavesOnly);
+		});
+	};
+
+	if (lookup.coordinateTable2Corner.isOpen()) {
+		search(lookup.coordinateTable2Corner);
+	} else {
+		search(lookup.coordinateMap2Corner);
+	}
+
+	return solutions;
+}
+
+template<typename Table>
+void Solver::searchMovesCoordinates(SearchConditionsCoordinates<Table>& searchConditions, const CrossAnd2CornersCoordinates coordinates, int depth,
+                                    const bool leavesOnly) {
+	auto &lookup = searchConditions.lookup;
+
+	const auto lookupChars = (leavesOnly && depth > 0) ? std::nullopt : findLookupMoves(lookup, coordinates.key());
+	if (lookupChars) {
+		const auto lookupMoves = Move::convertVectorCharToMove(*lookupChars);
 		const auto solution = Move::combineMovesWithLookupMoves(searchConditions.moves, lookupMoves);
 
 		Solution newSol;
@@ -138,16 +637,98 @@ void Solver::searchMovesNewHash(SearchConditionsNewHash& searchConditions, int d
 	{
 		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
 
+		CrossAnd2CornersCoordinates next = coordinates;
+		next.turnIndex(m.move - 'A', searchConditions.moveTables);
+
 		moves.push_back(m);
-		cube.turn(m);
+		searchMovesCoordinates(searchConditions, next, depth - 1, leavesOnly);
+		moves.pop_back();
+	}
+}
 
-		searchMovesNewHash(searchConditions, depth - 1);
+std::vector<Move> Solver::solveUpTo2CornersUsingIDAStar(RubiksCube &cube, Lookup &lookup, const int maxDepth) {
+	const std::vector<Solution> solutions = findCrossAnd2CornersUsingIDAStar(cube, lookup, maxDepth);
+	if (solutions.empty()) {return {};}
 
-		cube.turn(m.face, 4 - m.rotations);
+	return solutions.front().crossMoves;
+}
+
+std::vector<Solution> Solver::findCrossAnd2CornersUsingIDAStar(RubiksCube &cube, Lookup &lookup, const int maxDepth) {
+	if (!lookup.crossCornersDistance.isOpen() || !lookup.crossSlotEdgesDistance.isOpen()) {
+		lookup.makeDistanceTables2Corner();
+	}
+
+	std::vector<Move> moves;
+	moves.reserve(maxDepth);
+	std::vector<Solution> solutions;
+	SearchConditionsIDAStar searchConditions = {
+		CrossAnd2CornersCoordinates::moveTables(), lookup.crossCornersDistance, lookup.crossSlotEdgesDistance, moves, solutions
+	};
+
+	const CrossAnd2CornersCoordinates coordinates{CubieCube(cube)};
+	const int cornersDistance = lookup.crossCornersDistance.distance(coordinates.cross * CoordinateConst::twoCorners.size() + coordinates.corners);
+	const int slotEdgesDistance = lookup.crossSlotEdgesDistance.distance(coordinates.cross * CoordinateConst::slotEdges.size() + coordinates.slotEdges);
+
+	for (int depth = std::max(cornersDistance, slotEdgesDistance); depth <= maxDepth; depth++) {
+		searchMovesIDAStar(searchConditions, coordinates, cornersDistance, slotEdgesDistance, depth);
+		if (!solutions.empty()) {break;}
+	}
+
+	return solutions;
+}
+
+void Solver::searchMovesIDAStar(SearchConditionsIDAStar &searchConditions, const CrossAnd2CornersCoordinates coordinates,
+                                const int cornersDistance, const int slotEdgesDistance, const int depth) {
+	searchConditions.nodes++;
+
+	// Both tables at 0 means every tracked piece is home.
+	const int lowerBound = std::max(cornersDistance, slotEdgesDistance);
+	if (lowerBound == 0) {
+		Solution newSol;
+		newSol.crossMoves = searchConditions.moves;
+		searchConditions.solutions.push_back(newSol);
+		return;
+	}
+	if (lowerBound > depth) {return;}
+
+	auto &moves = searchConditions.moves;
+	const auto size = moves.size();
+	const Move prevMove = size > 0 ? moves[size - 1] : Move{7, 7};
+	const Move doublePrevMove = size > 1 ? moves[size - 2] : Move{7, 7};
+
+	for (Move m : RubiksConst::everyMove)
+	{
+		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+
+		CrossAnd2CornersCoordinates next = coordinates;
+		next.turnIndex(m.move - 'A', searchConditions.moveTables);
+
+		const int nextCornersDistance = searchConditions.crossCorners.distance(
+			next.cross * CoordinateConst::twoCorners.size() + next.corners, cornersDistance);
+		const int nextSlotEdgesDistance = searchConditions.crossSlotEdges.distance(
+			next.cross * CoordinateConst::slotEdges.size() + next.slotEdges, slotEdgesDistance);
+
+		moves.push_back(m);
+		searchMovesIDAStar(searchConditions, next, nextCornersDistance, nextSlotEdgesDistance, depth - 1);
 		moves.pop_back();
 	}
 }
 
+template void Solver::searchMovesNewHash(SearchConditionsNewHash<std::unordered_map<__int128, PackedMoves>> &, int, bool);
+template void Solver::searchMovesNewHash(SearchConditionsNewHash<MappedTable<__int128>> &, int, bool);
+template void Solver::searchMovesNewHash(SearchConditionsNewHash<FlatIndex<__int128>> &, int, bool);
+template void Solver::searchMovesNewHash(SearchConditionsNewHash<ParentMoveTable> &, int, bool);
+template void Solver::searchMovesMeetInTheMiddle(SearchConditionsNewHash<std::unordered_map<__int128, PackedMoves>> &, int);
+template void Solver::searchMovesMeetInTheMiddle(SearchConditionsNewHash<MappedTable<__int128>> &, int);
+template void Solver::searchMovesMeetInTheMiddle(SearchConditionsNewHash<FlatIndex<__int128>> &, int);
+template void Solver::searchMovesMeetInTheMiddle(SearchConditionsNewHash<ParentMoveTable> &, int);
+template void Solver::searchMovesStack(SearchConditionsStack<std::unordered_map<__int128, PackedMoves>> &, int, bool);
+template void Solver::searchMovesStack(SearchConditionsStack<MappedTable<__int128>> &, int, bool);
+template void Solver::searchMovesStack(SearchConditionsStack<FlatIndex<__int128>> &, int, bool);
+template void Solver::searchMovesStack(SearchConditionsStack<ParentMoveTable> &, int, bool);
+template void Solver::searchMovesCoordinates(SearchConditionsCoordinates<std::unordered_map<uint64_t, PackedMoves>> &, CrossAnd2CornersCoordinates, int, bool);
+template void Solver::searchMovesCoordinates(SearchConditionsCoordinates<MappedTable<uint64_t>> &, CrossAnd2CornersCoordinates, int, bool);
+
 std::vector<Move> Solver::solveUpTo3Corners(RubiksCube& cube, Lookup& lookup, int depth) {
 	std::array<short, 48> shuffleCubeCopy = cube.cube;
 
@@ -222,40 +803,64 @@ std::vector<Move> Solver::solveFullCubeUsingUnordered(RubiksCube& cube, Lookup&
 }
 
 
+// The moves stored for key in one of the array-keyed tables, as a std::map or a MappedSequenceTable.
+std::optional<std::vector<Move>> findSequenceMoves(const std::map<std::array<unsigned int, 4>, std::vector<char>> &lookup,
+                                                   const std::array<unsigned int, 4> &key) {
+	const auto it = lookup.find(key);
+	if (it == lookup.end()) {return std::nullopt;}
+	return Move::convertVectorCharToMove(it->second);
+}
+
+std::optional<std::vector<Move>> findSequenceMoves(const MappedSequenceTable &lookup, const std::array<unsigned int, 4> &key) {
+	const auto chars = lookup.find(key);
+	if (!chars) {return std::nullopt;}
+
+	std::vector<Move> out;
+	for (const char m : *chars) {
+		out.emplace_back(m);
+	}
+	return out;
+}
+
 std::vector<Solution> Solver::findCrossAnd2Corners(RubiksCube &cube, Lookup &lookup, int depth) {
 	if ((cube.numCornerSolved() == 2) && cube.solvedWhiteCross()) {return {};}
 
 	std::vector<Move> moves;
 	std::vector<Solution> solutions;
 
-	SearchConditions searchConditions = {cube, lookup.crossAnd2Corners, moves, solutions, TwoCorners};
-	searchMoves(searchConditions, depth);
+	auto search = [&](const auto &table) {
+		SearchConditions searchConditions = {cube, table, moves, solutions, TwoCorners};
+		searchDeepening(searchConditions, depth, [this](auto &conditions, const int d, const bool leavesOnly) {
+			searchSplit(conditions, d, searchParallel, searchExecutor(), [this, leavesOnly](auto &split, int splitDepth) {searchMoves(split, splitDepth, leavesOnly);});
+		}, [this]() {return searchStopped.load();});
+	};
 
-	if (solutions.empty()) {
-		// std::cout << "Had to increase depth" << "\n";
-		return findCrossAnd2Corners(cube, lookup, depth + 1);
-		// throw std::runtime_error("No solution found for this depth-limit and lookup combo.");
+	if (lookup.crossAnd2CornersTable.isOpen()) {
+		search(lookup.crossAnd2CornersTable);
 	} else {
-		return solutions;
+		search(lookup.crossAnd2Corners);
 	}
+
+	return solutions;
 }
 
 std::vector<Solution> Solver::findCrossAnd2CornersUnordered(RubiksCube& cube, Lookup& lookup, int depth) {
 	if ((cube.numCornerSolved() == 2) && cube.solvedWhiteCross()) {return {};}
 
+	// The unordered table is crossAnd2Corners rehashed, so the mapped table finds the same solutions.
+	if (lookup.smallerUnorderedCrossAnd2Corners.empty() && lookup.crossAnd2CornersTable.isOpen()) {
+		return findCrossAnd2Corners(cube, lookup, depth);
+	}
+
 	std::vector<Move> moves;
 	std::vector<Solution> solutions;
 
 	SearchConditionsUnordered searchConditions = {cube, lookup.smallerUnorderedCrossAnd2Corners, moves, solutions, TwoCorners};
-	searchMovesUnordered(searchConditions, depth);
+	searchDeepening(searchConditions, depth, [this](auto &conditions, const int d, const bool leavesOnly) {
+		searchSplit(conditions, d, searchParallel, searchExecutor(), [this, leavesOnly](auto &split, int splitDepth) {searchMovesUnordered(split, splitDepth, leavesOnly);});
+	}, [this]() {return searchStopped.load();});
 
-	if (solutions.empty()) {
-		// std::cout << "Had to increase depth" << "\n";
-		return findCrossAnd2Corners(cube, lookup, depth + 1);
-		// throw std::runtime_error("No solution found for this depth-limit and lookup combo.");
-	} else {
-		return solutions;
-	}
+	return solutions;
 }
 
 std::vector<Solution> Solver::findCrossAnd3Corners(RubiksCube &cube, Lookup &lookup, int depth) {
@@ -265,16 +870,15 @@ std::vector<Solution> Solver::findCrossAnd3Corners(RubiksCube &cube, Lookup &loo
 	std::vector<Solution> solutions;
 
 	SearchConditionsUnordered searchConditions = {cube, lookup.smallerUnorderedCrossAnd3Corners, moves, solutions, ThreeCorners};
-	searchMovesUnordered(searchConditions, depth);
+	searchDeepening(searchConditions, depth, [this](auto &conditions, const int d, const bool leavesOnly) {
+		if (leavesOnly) {
+			std::cout << "\n";
+			std::cout << "Had to increase depth to " << d << ".\n";
+		}
+		searchSplit(conditions, d, searchParallel, searchExecutor(), [this, leavesOnly](auto &split, int splitDepth) {searchMovesUnordered(split, splitDepth, leavesOnly);});
+	}, [this]() {return searchStopped.load();});
 
-	if (solutions.empty()) {
-		std::cout << "\n";
-		std::cout << "Had to increase depth to " << depth + 1 << ".\n";
-		return findCrossAnd3Corners(cube, lookup, depth + 1);
-		// throw std::runtime_error("No solution found for this depth-limit and lookup combo.");
-	} else {
-		return solutions;
-	}
+	return solutions;
 }
 
 void Solver::findAndTestSolutionsFirstTwoLayers(std::array<short, 48> &shuffled, Lookup &lookup, std::vector<Solution> &solutions) {
@@ -291,16 +895,15 @@ void Solver::findAndTestSolutionsFirstTwoLayers(std::array<short, 48> &shuffled,
 		}
 
 		auto hash = cube.hashFirstTwoLayers();
-		auto mapIter = lookup.solveTwoLayer.find(hash);
+		const auto movesFullLayer = lookup.solveTwoLayerTable.isOpen()
+			? findSequenceMoves(lookup.solveTwoLayerTable, hash)
+			: findSequenceMoves(lookup.solveTwoLayer, hash);
 
-		std::vector<Move> movesFullLayer;
-		if (mapIter != lookup.solveTwoLayer.end()) {
-			movesFullLayer = Move::convertVectorCharToMove(lookup.solveTwoLayer[hash]);
-		} else {
+		if (!movesFullLayer) {
 			throw std::runtime_error("Had to save two layer table");
 		}
 
-		for (auto m: movesFullLayer) {
+		for (auto m: *movesFullLayer) {
 			cube.turn(m);
 			sol.twoLayerMoves.emplace_back(m);
 		}
@@ -328,21 +931,22 @@ void Solver::findAndTestSolutionsLastLayer(std::array<short, 48> &shuffled, Look
 			cube.turn(m);
 		}
 
-		auto hash = cube.hashFullCube();
-		bool inMap = false;
+		std::optional<std::vector<Move>> restMoves;
 		for (int t = 0; t < 4; t++) {
 			cube.turn('P');
 			sol.lastLayerMoves.emplace_back('P');
-			hash = cube.hashFullCube();
+			const auto hash = cube.hashFullCube();
 
-			if (lookup.solveLastLayer.find(hash) != lookup.solveLastLayer.end()) {
-				inMap = true;
+			restMoves = lookup.solveLastLayerTable.isOpen()
+				? findSequenceMoves(lookup.solveLastLayerTable, hash)
+				: findSequenceMoves(lookup.solveLastLayer, hash);
+			if (restMoves) {
 				break;
 			}
 		}
 
-		auto restMoves = Move::convertVectorCharToMove(lookup.solveLastLayer[hash]);
-		for (auto &m : restMoves) {
+		// Without a hit the cube isn't solved and raiseSolved() throws.
+		for (auto &m : restMoves.value_or(std::vector<Move>{})) {
 			sol.lastLayerMoves.emplace_back(m);
 			cube.turn(m);
 		}
@@ -351,19 +955,19 @@ void Solver::findAndTestSolutionsLastLayer(std::array<short, 48> &shuffled, Look
 	}
 }
 
-void Solver::searchMoves(SearchConditions &searchConditions, int depth) {
+template<typename Table>
+void Solver::searchMoves(SearchConditions<Table> &searchConditions, int depth, const bool leavesOnly) {
 	auto &cube = searchConditions.cube;
 	auto &lookup = searchConditions.lookup;
 
-	auto lookupIterator = lookup.find(cube.getFromHash(searchConditions.hash));
-	if (lookupIterator != lookup.end()) {
-		auto lookupChars = lookup[cube.getFromHash(searchConditions.hash)];
-		auto lookupMoves = Move::convertVectorCharToMove(lookupChars);
-		auto solution = Move::combineMovesWithLookupMoves(searchConditions.moves, lookupMoves);
+	const auto lookupMoves = (leavesOnly && depth > 0) ? std::nullopt : findSequenceMoves(lookup, cube.getFromHash(searchConditions.hash));
+	if (lookupMoves) {
+		auto solution = Move::combineMovesWithLookupMoves(searchConditions.moves, *lookupMoves);
 
 		Solution newSol;
 		newSol.crossMoves = solution;
 		searchConditions.solutions.push_back(newSol);
+		foundSolution();
 
 		// std::cout << "\n";
 		// std::cout << "Found a solution!" << "\n";
@@ -387,17 +991,21 @@ void Solver::searchMoves(SearchConditions &searchConditions, int depth) {
 	for (Move m : RubiksConst::everyMove)
 	{
 		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+		if (stopSearch(depth)) {return;}
 
 		moves.push_back(m);
 		cube.turn(m);
 
-		searchMoves(searchConditions, depth - 1);
+		searchMoves(searchConditions, depth - 1, leavesOnly);
 
 		cube.turn(m.face, 4 - m.rotations);
 		moves.pop_back();
 	}
 }
 
+template void Solver::searchMoves(SearchConditions<std::map<std::array<unsigned int, 4>, std::vector<char>>> &, int, bool);
+template void Solver::searchMoves(SearchConditions<MappedSequenceTable> &, int, bool);
+
 std::vector<char> decodeMoves(uint64_t num, size_t length) {
 	std::vector<char> moves(length);
 
@@ -410,20 +1018,23 @@ std::vector<char> decodeMoves(uint64_t num, size_t length) {
 	return moves;
 }
 
-void Solver::searchMovesUnordered(SearchConditionsUnordered& searchConditions, int depth) {
+void Solver::searchMovesUnordered(SearchConditionsUnordered& searchConditions, int depth, const bool leavesOnly) {
 	auto &cube = searchConditions.cube;
 	auto &lookup = searchConditions.lookup;
 
-	auto hash = Lookup::hashF(cube.getFromHash(searchConditions.hash));
-	auto lookupIterator = lookup.find(hash);
+	auto lookupIterator = lookup.end();
+	if (!leavesOnly || depth == 0) {
+		lookupIterator = lookup.find(Lookup::hashF(cube.getFromHash(searchConditions.hash)));
+	}
 	if (lookupIterator != lookup.end()) {
-		auto lookupChars = lookup[hash];
+		auto &lookupChars = lookupIterator->second;
 		auto lookupMoves = Move::convertVectorCharToMove(lookupChars);
 		auto solution = Move::combineMovesWithLookupMoves(searchConditions.moves, lookupMoves);
 
 		Solution newSol;
 		newSol.crossMoves = solution;
 		searchConditions.solutions.push_back(newSol);
+		foundSolution();
 
 		// std::cout << "\n";
 		// std::cout << "Found a solution!" << "\n";
@@ -447,11 +1058,12 @@ void Solver::searchMovesUnordered(SearchConditionsUnordered& searchConditions, i
 	for (Move m : RubiksConst::everyMove)
 	{
 		if (Lookup::prune(m, prevMove, doublePrevMove)) { continue;}
+		if (stopSearch(depth)) {return;}
 
 		moves.push_back(m);
 		cube.turn(m);
 
-		searchMovesUnordered(searchConditions, depth - 1);
+		searchMovesUnordered(searchConditions, depth - 1, leavesOnly);
 
 		cube.turn(m.face, 4 - m.rotations);
 		moves.pop_back();
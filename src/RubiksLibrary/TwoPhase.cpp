@@ -0,0 +1,530 @@
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "RubiksLibrary/TwoPhase.hpp"
+#include "RubiksLibrary/Lookup.hpp"
+
+// Lehmer code of a permutation of 0..N-1, the identity is 0.
+template<size_t N>
+uint32_t rankPermutation(const std::array<uint8_t, N> &permutation) {
+    uint32_t rank = 0;
+    for (size_t i = 0; i < N; i++) {
+        uint32_t smaller = 0;
+        for (size_t j = i + 1; j < N; j++) {
+            smaller += permutation[j] < permutation[i];
+        }
+        rank = rank * static_cast<uint32_t>(N - i) + smaller;
+    }
+    return rank;
+}
+
+template<size_t N>
+std::array<uint8_t, N> unrankPermutation(uint32_t rank) {
+    std::array<uint8_t, N> digits{};
+    for (size_t i = N; i-- > 0;) {
+        digits[i] = static_cast<uint8_t>(rank % (N - i));
+        rank /= static_cast<uint32_t>(N - i);
+    }
+
+    std::array<uint8_t, N> permutation{};
+    std::array<bool, N> used{};
+    for (size_t i = 0; i < N; i++) {
+        uint8_t value = 0;
+        for (int skip = digits[i]; ; value++) {
+            if (used[value]) { continue; }
+            if (skip-- == 0) { break; }
+        }
+        used[value] = true;
+        permutation[i] = value;
+    }
+    return permutation;
+}
+
+uint32_t binomial(const uint32_t n, const uint32_t k) {
+    if (k > n) { return 0; }
+
+    uint32_t out = 1;
+    for (uint32_t i = 0; i < k; i++) {
+        out = out * (n - i) / (i + 1);
+    }
+    return out;
+}
+
+// Index of the layer edge slots 0-3 and 8-11 among themselves.
+static uint8_t layerSlotIndex(const uint8_t slot) {
+    return slot < 4 ? slot : static_cast<uint8_t>(slot - 4);
+}
+
+// The orientations are read per slot, a move only moves them between slots.
+uint32_t TwoPhaseCoordinates::twist(const CubieCube &cube) {
+    std::array<uint8_t, 8> twists{};
+    for (const auto location : cube.corners) {
+        twists[location / 3] = location % 3;
+    }
+
+    uint32_t out = 0;
+    for (int slot = 0; slot < 7; slot++) {
+        out = out * 3 + twists[slot];
+    }
+    return out;
+}
+
+uint32_t TwoPhaseCoordinates::flip(const CubieCube &cube) {
+    std::array<uint8_t, 12> flips{};
+    for (const auto location : cube.edges) {
+        flips[location / 2] = location % 2;
+    }
+
+    uint32_t out = 0;
+    for (int slot = 0; slot < 11; slot++) {
+        out = out * 2 + flips[slot];
+    }
+    return out;
+}
+
+uint32_t TwoPhaseCoordinates::slice(const CubieCube &cube) {
+    std::array<uint8_t, 4> slots{};
+    for (size_t i = 0; i < slots.size(); i++) {
+        slots[i] = cube.edges[TwoPhaseConst::sliceEdges[i]] / 2;
+    }
+    std::sort(slots.begin(), slots.end());
+
+    uint32_t out = 0;
+    for (uint32_t i = 0; i < slots.size(); i++) {
+        out += binomial(slots[i], i + 1);
+    }
+    return out;
+}
+
+uint32_t TwoPhaseCoordinates::cornerPermutation(const CubieCube &cube) {
+    std::array<uint8_t, 8> permutation{};
+    for (size_t p = 0; p < permutation.size(); p++) {
+        permutation[p] = cube.corners[p] / 3;
+    }
+    return rankPermutation(permutation);
+}
+
+uint32_t TwoPhaseCoordinates::layerEdgePermutation(const CubieCube &cube) {
+    std::array<uint8_t, 8> permutation{};
+    for (size_t i = 0; i < permutation.size(); i++) {
+        permutation[i] = layerSlotIndex(cube.edges[TwoPhaseConst::layerEdges[i]] / 2);
+    }
+    return rankPermutation(permutation);
+}
+
+uint32_t TwoPhaseCoordinates::slicePermutation(const CubieCube &cube) {
+    std::array<uint8_t, 4> permutation{};
+    for (size_t i = 0; i < permutation.size(); i++) {
+        permutation[i] = static_cast<uint8_t>(cube.edges[TwoPhaseConst::sliceEdges[i]] / 2 - 4);
+    }
+    return rankPermutation(permutation);
+}
+
+// The inverses of the coordinates above, with every other piece solved or in the first free slot.
+static CubieCube twistCube(uint32_t twist) {
+    CubieCube cube;
+    int sum = 0;
+    for (int p = 6; p >= 0; p--) {
+        const int orientation = static_cast<int>(twist % 3);
+        twist /= 3;
+        cube.corners[p] = static_cast<uint8_t>(p * 3 + orientation);
+        sum += orientation;
+    }
+    cube.corners[7] = static_cast<uint8_t>(7 * 3 + (3 - sum % 3) % 3);
+    return cube;
+}
+
+static CubieCube flipCube(uint32_t flip) {
+    CubieCube cube;
+    int sum = 0;
+    for (int p = 10; p >= 0; p--) {
+        const int orientation = static_cast<int>(flip % 2);
+        flip /= 2;
+        cube.edges[p] = static_cast<uint8_t>(p * 2 + orientation);
+        sum += orientation;
+    }
+    cube.edges[11] = static_cast<uint8_t>(11 * 2 + sum % 2);
+    return cube;
+}
+
+static CubieCube sliceCube(uint32_t slice) {
+    std::array<bool, 12> sliceSlot{};
+    for (uint32_t k = 4; k > 0; k--) {
+        uint32_t slot = k - 1;
+        while (binomial(slot + 1, k) <= slice) { slot++; }
+        slice -= binomial(slot, k);
+        sliceSlot[slot] = true;
+    }
+
+    CubieCube cube;
+    size_t nextSlice = 0;
+    size_t nextLayer = 0;
+    for (uint8_t slot = 0; slot < 12; slot++) {
+        const int piece = sliceSlot[slot] ? TwoPhaseConst::sliceEdges[nextSlice++] : TwoPhaseConst::layerEdges[nextLayer++];
+        cube.edges[piece] = static_cast<uint8_t>(slot * 2);
+    }
+    return cube;
+}
+
+static CubieCube cornerPermutationCube(const uint32_t rank) {
+    const auto permutation = unrankPermutation<8>(rank);
+
+    CubieCube cube;
+    for (size_t p = 0; p < permutation.size(); p++) {
+        cube.corners[p] = static_cast<uint8_t>(permutation[p] * 3);
+    }
+    return cube;
+}
+
+static CubieCube layerEdgePermutationCube(const uint32_t rank) {
+    const auto permutation = unrankPermutation<8>(rank);
+
+    CubieCube cube;
+    for (size_t i = 0; i < permutation.size(); i++) {
+        cube.edges[TwoPhaseConst::layerEdges[i]] = static_cast<uint8_t>(TwoPhaseConst::layerEdges[permutation[i]] * 2);
+    }
+    return cube;
+}
+
+static CubieCube slicePermutationCube(const uint32_t rank) {
+    const auto permutation = unrankPermutation<4>(rank);
+
+    CubieCube cube;
+    for (size_t i = 0; i < permutation.size(); i++) {
+        cube.edges[TwoPhaseConst::sliceEdges[i]] = static_cast<uint8_t>((permutation[i] + 4) * 2);
+    }
+    return cube;
+}
+
+// Reads DATA_PATH/title.bin, or fills the columns of moveIndices and writes it there.
+template<typename Rank, typename Unrank>
+static CoordinateMoveTable loadOrMakeMoveTable(const uint32_t size, const std::vector<int> &moveIndices,
+                                               Rank rank, Unrank unrank, const std::string &title) {
+    CoordinateMoveTable table;
+    if (table.load(title, size)) {
+        return table;
+    }
+
+    std::cout << "Generating move table " << title << ".\n";
+    table.next.assign(static_cast<size_t>(size) * 18, 0);
+    for (uint32_t c = 0; c < size; c++) {
+        const CubieCube cube = unrank(c);
+
+        for (const int m : moveIndices) {
+            CubieCube turned = cube;
+            turned.turnIndex(m);
+            table.next[c * 18 + m] = rank(turned);
+        }
+    }
+
+    table.save(title);
+    return table;
+}
+
+const TwoPhaseSolver::Tables &TwoPhaseSolver::tables() {
+    // The pruning tables point into the move tables, so they are built in place.
+    static Tables tables;
+    static std::once_flag once;
+
+    std::call_once(once, [] {
+        using namespace TwoPhaseConst;
+
+        const CubieCube solved;
+        tables.solvedSlice = TwoPhaseCoordinates::slice(solved);
+
+        // The moves that keep a cube in the phase 2 group.
+        std::vector<int> allMoves;
+        for (int m = 0; m < 18; m++) {
+            allMoves.push_back(m);
+
+            CubieCube turned = solved;
+            turned.turnIndex(m);
+            tables.isPhase2Move[m] = TwoPhaseCoordinates::twist(turned) == 0 && TwoPhaseCoordinates::flip(turned) == 0 &&
+                                     TwoPhaseCoordinates::slice(turned) == tables.solvedSlice;
+            if (tables.isPhase2Move[m]) {
+                tables.phase2Moves.push_back(m);
+            }
+        }
+
+        tables.twist = loadOrMakeMoveTable(numTwists, allMoves, TwoPhaseCoordinates::twist, twistCube, "moveTableTwoPhaseTwist");
+        tables.flip = loadOrMakeMoveTable(numFlips, allMoves, TwoPhaseCoordinates::flip, flipCube, "moveTableTwoPhaseFlip");
+        tables.slice = loadOrMakeMoveTable(numSlices, allMoves, TwoPhaseCoordinates::slice, sliceCube, "moveTableTwoPhaseSlice");
+
+        const auto &phase2 = tables.phase2Moves;
+        tables.cornerPermutation = loadOrMakeMoveTable(numCornerPermutations, phase2, TwoPhaseCoordinates::cornerPermutation,
+                                                       cornerPermutationCube, "moveTableTwoPhaseCornerPermutation");
+        tables.layerEdgePermutation = loadOrMakeMoveTable(numLayerEdgePermutations, phase2, TwoPhaseCoordinates::layerEdgePermutation,
+                                                          layerEdgePermutationCube, "moveTableTwoPhaseLayerEdgePermutation");
+        tables.slicePermutation = loadOrMakeMoveTable(numSlicePermutations, phase2, TwoPhaseCoordinates::slicePermutation,
+                                                      slicePermutationCube, "moveTableTwoPhaseSlicePermutation");
+
+        tables.twistSlice = PruningTable::loadOrGenerate(
+            {&tables.twist, &tables.slice}, {numTwists, numSlices}, tables.solvedSlice, 4, "distanceTwoPhaseTwistSlice");
+        tables.flipSlice = PruningTable::loadOrGenerate(
+            {&tables.flip, &tables.slice}, {numFlips, numSlices}, tables.solvedSlice, 4, "distanceTwoPhaseFlipSlice");
+        tables.twistFlip = PruningTable::loadOrGenerate(
+            {&tables.twist, &tables.flip}, {numTwists, numFlips}, 0, 4, "distanceTwoPhaseTwistFlip");
+        tables.cornerSlice = PruningTable::loadOrGenerate(
+            {&tables.cornerPermutation, &tables.slicePermutation}, {numCornerPermutations, numSlicePermutations}, 0, 4,
+            "distanceTwoPhaseCornerSlice", phase2);
+        tables.layerEdgeSlice = PruningTable::loadOrGenerate(
+            {&tables.layerEdgePermutation, &tables.slicePermutation}, {numLayerEdgePermutations, numSlicePermutations}, 0, 4,
+            "distanceTwoPhaseLayerEdgeSlice", phase2);
+    });
+
+    return tables;
+}
+
+struct TwoPhaseSearch {
+    TwoPhaseSearch(const TwoPhaseSolver::Tables &tables, const CubieCube &start, const int targetLength,
+                   const std::chrono::steady_clock::time_point deadline)
+        : tables(tables), start(start), targetLength(targetLength), deadline(deadline) {}
+
+    const TwoPhaseSolver::Tables &tables;
+    const CubieCube &start;
+    int targetLength;
+
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t nodes = 0;
+    bool timedOut = false;
+
+    // Phase 1 moves, followed by phase 2 moves while phase 2 searches.
+    std::vector<int> moves;
+    std::vector<int> best;
+    int bestLength = TwoPhaseConst::maxPhase1Length + TwoPhaseConst::maxPhase2Length + 1;
+
+    // Set while phase 2 runs. tailFaces is the face phase 1 ended on and its opposite, tail the last phase 1
+    // move on each of them, or -1 where the end of phase 1 has none. Phase 2 may start with half turns of
+    // these faces in any order, as the turns commute, and a half turn merges into the tail move of its face.
+    std::array<int, 2> tailFaces{-1, -1};
+    std::array<int, 2> tail{-1, -1};
+};
+
+// Reads the clock every 1024 nodes. Once out of time, the searches return true to unwind.
+static bool outOfTime(TwoPhaseSearch &search) {
+    if (search.timedOut) {return true;}
+    if (++search.nodes % 1024 != 0 || search.deadline == std::chrono::steady_clock::time_point::max()) {return false;}
+
+    search.timedOut = std::chrono::steady_clock::now() >= search.deadline;
+    return search.timedOut;
+}
+
+static Move previousMove(const std::vector<int> &moves, const size_t back) {
+    return moves.size() > back ? RubiksConst::everyMove[moves[moves.size() - 1 - back]] : Move{7, 7};
+}
+
+// Which of search.tailFaces m turns, if phase 2 is still at its start and hasn't turned that face yet.
+static int tailFaceIndex(const TwoPhaseSearch &search, const int head, const int m) {
+    for (int k = 0; k < 2 && head >= 0; k++) {
+        if (search.tailFaces[k] == m / 3 && !(head >> k & 1)) {return k;}
+    }
+    return -1;
+}
+
+// saved is how many moves the merged phase 2 moves took off, head which tail faces phase 2 has turned. head is
+// -1 once phase 2 has turned another face, nothing after that merges.
+static bool searchPhase2(TwoPhaseSearch &search, const uint32_t corners, const uint32_t layerEdges, const uint32_t slice,
+                         const int depth, const int saved, const int head) {
+    if (outOfTime(search)) {return true;}
+    if (depth == 0) {
+        return corners == 0 && layerEdges == 0 && slice == 0 && static_cast<int>(search.moves.size()) - saved < search.bestLength;
+    }
+
+    const auto &tables = search.tables;
+    const int lowerBound = std::max(
+        tables.cornerSlice.distance(static_cast<uint64_t>(corners) * TwoPhaseConst::numSlicePermutations + slice),
+        tables.layerEdgeSlice.distance(static_cast<uint64_t>(layerEdges) * TwoPhaseConst::numSlicePermutations + slice));
+    if (lowerBound > depth) {return false;}
+
+    const Move prevMove = previousMove(search.moves, 0);
+    const Move doublePrevMove = previousMove(search.moves, 1);
+
+    for (const int m : tables.phase2Moves) {
+        const int tailIndex = tailFaceIndex(search, head, m);
+
+        int nextSaved = saved;
+        int nextHead = -1;
+        if (tailIndex >= 0) {
+            // A half turn cancels a half turn in the tail, and turns a quarter turn into the opposite one.
+            const int tailMove = search.tail[tailIndex];
+            nextSaved += tailMove < 0 ? 0 : tailMove % 3 == 1 ? 2 : 1;
+            nextHead = head | 1 << tailIndex;
+        } else {
+            if (Lookup::prune(RubiksConst::everyMove[m], prevMove, doublePrevMove)) { continue;}
+            if (static_cast<int>(search.moves.size()) + depth - saved >= search.bestLength) { continue;}
+        }
+
+        search.moves.push_back(m);
+        if (searchPhase2(search, tables.cornerPermutation.turn(corners, m), tables.layerEdgePermutation.turn(layerEdges, m),
+                         tables.slicePermutation.turn(slice, m), depth - 1, nextSaved, nextHead)) {
+            return true;
+        }
+        search.moves.pop_back();
+    }
+    return false;
+}
+
+// search.moves with the phase 2 moves that searchPhase2 merged taken into the tail of phase 1.
+static std::vector<int> mergedMoves(const TwoPhaseSearch &search, const size_t phase1Length) {
+    std::vector<int> out(search.moves.begin(), search.moves.begin() + static_cast<std::ptrdiff_t>(phase1Length));
+
+    int head = 0;
+    size_t i = phase1Length;
+    for (; i < search.moves.size(); i++) {
+        const int m = search.moves[i];
+        const int tailIndex = tailFaceIndex(search, head, m);
+        if (tailIndex < 0) {break;}
+        head |= 1 << tailIndex;
+
+        if (search.tail[tailIndex] < 0) {
+            out.push_back(m);
+            continue;
+        }
+
+        // The tail move of face k is k moves before the end of phase 1.
+        auto &tailMove = out[phase1Length - 1 - tailIndex];
+        const int rotations = (tailMove % 3 + m % 3 + 2) % 4;
+        tailMove = rotations == 0 ? -1 : m / 3 * 3 + rotations - 1;
+    }
+
+    std::erase(out, -1);
+    out.insert(out.end(), search.moves.begin() + static_cast<std::ptrdiff_t>(i), search.moves.end());
+    return out;
+}
+
+// Completes the phase 1 solution in search.moves with the shortest phase 2 that beats the best so far.
+static bool startPhase2(TwoPhaseSearch &search) {
+    CubieCube cube = search.start;
+    for (const int m : search.moves) {
+        cube.turnIndex(m);
+    }
+
+    const auto &tables = search.tables;
+    const uint32_t corners = TwoPhaseCoordinates::cornerPermutation(cube);
+    const uint32_t layerEdges = TwoPhaseCoordinates::layerEdgePermutation(cube);
+    const uint32_t slice = TwoPhaseCoordinates::slicePermutation(cube);
+
+    // Phase 1 ends on a quarter turn, and may have the opposite face turned just before it.
+    const int phase1Length = static_cast<int>(search.moves.size());
+    search.tailFaces = {-1, -1};
+    search.tail = {-1, -1};
+    int maxSaved = 0;
+    if (phase1Length > 0) {
+        search.tailFaces = {search.moves.back() / 3, RubiksConst::oppositeFaceAll[search.moves.back() / 3]};
+        for (int k = 0; k < 2 && k < phase1Length; k++) {
+            const int m = search.moves[phase1Length - 1 - k];
+            if (m / 3 != search.tailFaces[k]) {break;}
+
+            search.tail[k] = m;
+            maxSaved += m % 3 == 1 ? 2 : 1;
+        }
+    }
+
+    const int maxLength = std::min(TwoPhaseConst::maxPhase2Length, search.bestLength - 1 - phase1Length + maxSaved);
+    const int lowerBound = std::max(
+        tables.cornerSlice.distance(static_cast<uint64_t>(corners) * TwoPhaseConst::numSlicePermutations + slice),
+        tables.layerEdgeSlice.distance(static_cast<uint64_t>(layerEdges) * TwoPhaseConst::numSlicePermutations + slice));
+
+    for (int depth = lowerBound; depth <= maxLength; depth++) {
+        if (searchPhase2(search, corners, layerEdges, slice, depth, 0, 0)) {
+            if (search.timedOut) {
+                search.moves.resize(phase1Length);
+                return true;
+            }
+
+            search.best = mergedMoves(search, phase1Length);
+            search.bestLength = static_cast<int>(search.best.size());
+            search.moves.resize(phase1Length);
+            break;
+        }
+    }
+
+    return search.bestLength <= search.targetLength;
+}
+
+static bool searchPhase1(TwoPhaseSearch &search, const uint32_t twist, const uint32_t flip, const uint32_t slice, const int depth) {
+    if (outOfTime(search)) {return true;}
+
+    const auto &tables = search.tables;
+    const int lowerBound = std::max({
+        tables.twistSlice.distance(static_cast<uint64_t>(twist) * TwoPhaseConst::numSlices + slice),
+        tables.flipSlice.distance(static_cast<uint64_t>(flip) * TwoPhaseConst::numSlices + slice),
+        tables.twistFlip.distance(static_cast<uint64_t>(twist) * TwoPhaseConst::numFlips + flip)});
+
+    if (depth == 0) {
+        if (lowerBound != 0) {return false;}
+
+        // Ending on a phase 2 move, the shorter phase 1 without it was already tried.
+        if (!search.moves.empty() && tables.isPhase2Move[search.moves.back()]) {return false;}
+
+        return startPhase2(search);
+    }
+    if (lowerBound > depth) {return false;}
+
+    const Move prevMove = previousMove(search.moves, 0);
+    const Move doublePrevMove = previousMove(search.moves, 1);
+
+    for (int m = 0; m < 18; m++) {
+        if (Lookup::prune(RubiksConst::everyMove[m], prevMove, doublePrevMove)) { continue;}
+
+        search.moves.push_back(m);
+        if (searchPhase1(search, tables.twist.turn(twist, m), tables.flip.turn(flip, m), tables.slice.turn(slice, m), depth - 1)) {
+            return true;
+        }
+        search.moves.pop_back();
+    }
+    return false;
+}
+
+// Corner twists sum to 0 mod 3, edge flips to 0 mod 2, and the corner and edge permutations share a parity.
+static bool solvable(const CubieCube &cube) {
+    int twist = 0;
+    int cornerParity = 0;
+    for (int p = 0; p < 8; p++) {
+        twist += cube.corners[p] % 3;
+        for (int q = p + 1; q < 8; q++) {
+            cornerParity ^= cube.corners[q] / 3 < cube.corners[p] / 3;
+        }
+    }
+
+    int flip = 0;
+    int edgeParity = 0;
+    for (int p = 0; p < 12; p++) {
+        flip += cube.edges[p] % 2;
+        for (int q = p + 1; q < 12; q++) {
+            edgeParity ^= cube.edges[q] / 2 < cube.edges[p] / 2;
+        }
+    }
+
+    return twist % 3 == 0 && flip % 2 == 0 && cornerParity == edgeParity;
+}
+
+std::vector<Move> TwoPhaseSolver::solve(const RubiksCube &cube, const int targetLength, const std::chrono::steady_clock::time_point deadline) {
+    return solve(CubieCube(cube), targetLength, deadline);
+}
+
+std::vector<Move> TwoPhaseSolver::solve(const CubieCube &cube, const int targetLength, const std::chrono::steady_clock::time_point deadline) {
+    if (!solvable(cube)) {
+        throw std::runtime_error("Cube is not solvable.");
+    }
+
+    TwoPhaseSearch search{tables(), cube, targetLength, deadline};
+    search.moves.reserve(TwoPhaseConst::maxPhase1Length + TwoPhaseConst::maxPhase2Length);
+
+    const uint32_t twist = TwoPhaseCoordinates::twist(cube);
+    const uint32_t flip = TwoPhaseCoordinates::flip(cube);
+    const uint32_t slice = TwoPhaseCoordinates::slice(cube);
+
+    for (int depth = 0; depth <= TwoPhaseConst::maxPhase1Length && depth < search.bestLength; depth++) {
+        if (searchPhase1(search, twist, flip, slice, depth)) {break;}
+    }
+
+    std::vector<Move> out;
+    for (const int m : search.best) {
+        out.push_back(RubiksConst::everyMove[m]);
+    }
+    return out;
+}
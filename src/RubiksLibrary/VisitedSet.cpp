@@ -0,0 +1,71 @@
+#include "RubiksLibrary/VisitedSet.hpp"
+
+VisitedSet::VisitedSet(const uint64_t indexSize): indexSize(indexSize), slots(1024, empty) {}
+
+size_t VisitedSet::findSlot(const uint64_t index) const {
+    uint64_t x = index * 0x9e3779b97f4a7c15ULL;
+    x ^= x >> 32;
+
+    const size_t mask = slots.size() - 1;
+    size_t slot = x & mask;
+    while (slots[slot] != empty && slots[slot] != index) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void VisitedSet::rehash(const size_t numSlots) {
+    std::vector<uint64_t> previous(numSlots, empty);
+    previous.swap(slots);
+
+    for (const auto index : previous) {
+        if (index != empty) {
+            slots[findSlot(index)] = index;
+        }
+    }
+}
+
+void VisitedSet::convertToBitset() {
+    bits.assign((indexSize + 63) / 64, 0);
+    for (const auto index : slots) {
+        if (index != empty) {
+            bits[index / 64] |= 1ULL << (index % 64);
+        }
+    }
+    std::vector<uint64_t>().swap(slots);
+}
+
+bool VisitedSet::insert(const uint64_t index) {
+    if (!isBitset() && 2 * (count + 1) > slots.size()) {
+        // The doubled hash table would be larger than the bitset.
+        if (2 * slots.size() * sizeof(uint64_t) >= indexSize / 8) {
+            convertToBitset();
+        } else {
+            rehash(2 * slots.size());
+        }
+    }
+
+    if (isBitset()) {
+        uint64_t &word = bits[index / 64];
+        const uint64_t bit = 1ULL << (index % 64);
+        if (word & bit) { return false; }
+
+        word |= bit;
+        count++;
+        return true;
+    }
+
+    const size_t slot = findSlot(index);
+    if (slots[slot] == index) { return false; }
+
+    slots[slot] = index;
+    count++;
+    return true;
+}
+
+bool VisitedSet::contains(const uint64_t index) const {
+    if (isBitset()) {
+        return bits[index / 64] & (1ULL << (index % 64));
+    }
+    return slots[findSlot(index)] == index;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "RubiksLibrary/WorkStealing.hpp"
+
+// The executor and worker index of the thread running a task, so spawn() knows which deque to use.
+thread_local const WorkStealingExecutor *currentExecutor = nullptr;
+thread_local unsigned currentWorker = 0;
+
+WorkStealingExecutor::WorkStealingExecutor(const unsigned workers) {
+    if (workers == 0) {
+        throw std::runtime_error("A WorkStealingExecutor needs at least one worker.");
+    }
+
+    for (unsigned i = 0; i < workers; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 1; i < workers; i++) {
+        threads.emplace_back(&WorkStealingExecutor::serve, this, i);
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    runChanged.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingExecutor::spawn(Task task) {
+    const unsigned worker = currentExecutor == this ? currentWorker : 0;
+
+    unfinished++;
+    {
+        std::lock_guard lock(queues[worker]->mutex);
+        queues[worker]->tasks.push_back(std::move(task));
+        queued++;
+    }
+    wakeIdle(false);
+}
+
+void WorkStealingExecutor::wakeIdle(const bool all) {
+    // A worker counts itself idle before it checks for work, so either it sees the new task or this sees it.
+    if (idle.load() == 0) { return; }
+
+    { std::lock_guard lock(sleepMutex); }
+    if (all) {
+        taskReady.notify_all();
+    } else {
+        taskReady.notify_one();
+    }
+}
+
+bool WorkStealingExecutor::take(const unsigned worker, Task &task) {
+    {
+        auto &own = *queues[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    for (unsigned i = 1; i < queues.size(); i++) {
+        auto &victim = *queues[(worker + i) % queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingExecutor::work(const unsigned worker) {
+    const auto *previousExecutor = currentExecutor;
+    const unsigned previousWorker = currentWorker;
+    currentExecutor = this;
+    currentWorker = worker;
+
+    Task task;
+    while (unfinished.load() > 0) {
+        if (!take(worker, task)) {
+            // Nothing to steal, sleep until a task is spawned or the last one finishes.
+            std::unique_lock lock(sleepMutex);
+            idle++;
+            taskReady.wait(lock, [this]() {return queued.load() > 0 || unfinished.load() == 0;});
+            idle--;
+            continue;
+        }
+
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(errorMutex);
+            if (!error) { error = std::current_exception(); }
+        }
+        task = nullptr;
+        if (--unfinished == 0) { wakeIdle(true); }
+    }
+
+    currentExecutor = previousExecutor;
+    currentWorker = previousWorker;
+}
+
+void WorkStealingExecutor::serve(const unsigned worker) {
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(sleepMutex);
+            runChanged.wait(lock, [&]() {return stopping || runs != seen;});
+            if (stopping) { return; }
+            seen = runs;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard lock(sleepMutex);
+            running--;
+        }
+        runChanged.notify_all();
+    }
+}
+
+void WorkStealingExecutor::run() {
+    {
+        std::lock_guard lock(sleepMutex);
+        runs++;
+        running = workers() - 1;
+    }
+    runChanged.notify_all();
+
+    work(0);
+
+    // The other workers may still be on their way out of work(), the next run() must not start under them.
+    {
+        std::unique_lock lock(sleepMutex);
+        runChanged.wait(lock, [this]() {return running == 0;});
+    }
+
+    if (error) {
+        auto thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+void WorkStealingExecutor::parallelFor(const size_t count, size_t grain, const std::function<void(size_t, size_t)> &body) {
+    grain = std::max<size_t>(grain, 1);
+    std::function<void(size_t, size_t)> range = [&](size_t begin, size_t end) {
+        while (end - begin > grain) {
+            const size_t middle = begin + (end - begin) / 2;
+            spawn([&range, middle, end]() {range(middle, end);});
+            end = middle;
+        }
+        body(begin, end);
+    };
+
+    if (count == 0) { return; }
+    spawn([&range, count]() {range(0, count);});
+    run();
+}
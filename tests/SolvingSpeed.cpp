@@ -2,10 +2,17 @@
 #include <iostream>
 #include <chrono>
 #include <bitset>
+#include <thread>
 
 #include "RubiksLibrary/Solver.hpp"
 #include "RubiksLibrary/Lookup.hpp"
 #include "RubiksLibrary/RubiksCube.hpp"
+#include "RubiksLibrary/PackedCube.hpp"
+#include "RubiksLibrary/CpuDispatch.hpp"
+#include "RubiksLibrary/CubieCube.hpp"
+#include "RubiksLibrary/HashedCube.hpp"
+#include "RubiksLibrary/Coordinate.hpp"
+#include "RubiksLibrary/TwoPhase.hpp"
 
 #define MILLION 1000000
 #define THOUSAND 1000
@@ -216,6 +223,51 @@ void testNumSolvingMoves() {
 	// Solved 100 cubes, avg number of moves: 28.73. Total time:  5077 | Avg time: 50.77 (no idea)
 }
 
+void testSolveModes() {
+	Solver solver = Solver();
+	RubiksCube cube = RubiksCube();
+
+	auto lookup = Lookup::loadAllMaps();
+	std::cout << "Finished loading maps." << "\n";
+
+	for (const auto mode : {SolveMode::best, SolveMode::firstHit, SolveMode::anytime}) {
+		unsigned long totNumMoves = 0;
+		int improvements = 0;
+		int unsolved = 0;
+		long long slowest = 0;
+
+		int num_test = 100;
+		auto now = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < num_test; i++) {
+			cube.shuffle(50);
+
+			SolveOptions options;
+			options.mode = mode;
+			if (mode == SolveMode::anytime) {
+				options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+			}
+			options.onImprovement = [&improvements](const std::vector<Move> &) {improvements++;};
+
+			auto t0 = std::chrono::high_resolution_clock::now();
+			auto solvingMoves = solver.solveFullCube(cube, lookup, options);
+			auto t1 = std::chrono::high_resolution_clock::now();
+
+			// The deadline is hard, a cube without a solution by then comes back empty.
+			if (solvingMoves.empty()) {unsolved++;}
+			totNumMoves += solvingMoves.size();
+			slowest = std::max<long long>(slowest, std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count());
+		}
+		std::cout << "Mode " << static_cast<int>(mode) << ": solved " << num_test << " cubes, avg number of moves: "
+		<< static_cast<double>(totNumMoves) / static_cast<double>(std::max(num_test - unsolved, 1))
+		<< ", improvements: " << improvements << ", unsolved: " << unsolved << ".\n";
+
+		auto after = std::chrono::high_resolution_clock::now();
+		auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+		std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+		<< " | Slowest: " << slowest << "\n";
+	}
+}
+
 void testSolving3Corners() {
 	Solver solver = Solver();
 	RubiksCube cube = RubiksCube();
@@ -293,6 +345,290 @@ void testNumSolvingMovesTwoCornerNewHash() {
 	<< "\n";
 }
 
+void testNumSolvingMovesTwoCornerArena() {
+	RubiksCube cube = RubiksCube();
+
+	Lookup lookup;
+	std::string title = "newHashMap2CornersConstructedDepth7";
+	Lookup::load(lookup.newHashMap2Corner, title);
+	lookup.buildIndexes();
+	std::cout << "Finished loading maps." << "\n";
+
+	SearchArena arena;
+	unsigned long totNumMoves = 0;
+
+	int num_test = 100;
+	auto now = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < num_test; i++) {
+		cube.shuffle(50);
+		auto solvingMoves = Solver::solveUpTo2CornersInArena(cube, lookup, arena, 4);
+		totNumMoves += solvingMoves.size();
+	}
+	std::cout << "Solved " << num_test << " cubes, avg number of moves: " << static_cast<double>(totNumMoves) / static_cast<double>(num_test)
+	<< ", arena capacity: " << arena.solutions.capacity() << ".\n";
+
+	auto after = std::chrono::high_resolution_clock::now();
+	auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+	std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+	<< "\n";
+}
+
+void testNumSolvingMovesTwoCornerCoordinates() {
+	RubiksCube cube = RubiksCube();
+
+	Lookup lookup;
+	std::string title = "coordinateMap2CornerDepth7";
+	Lookup::load(lookup.coordinateMap2Corner, title);
+	std::cout << "Finished loading maps." << "\n";
+
+	unsigned long totNumMoves = 0;
+
+	int num_test = 100;
+	auto now = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < num_test; i++) {
+		cube.shuffle(50);
+		auto solvingMoves = Solver::solveUpTo2CornersUsingCoordinates(cube, lookup, 4);
+		totNumMoves += solvingMoves.size();
+	}
+	std::cout << "Solved " << num_test << " cubes, avg number of moves: " << static_cast<double>(totNumMoves) / static_cast<double>(num_test) << ".\n";
+
+	auto after = std::chrono::high_resolution_clock::now();
+	auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+	std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+	<< "\n";
+}
+
+void testNumSolvingMovesTwoCornerMeetInTheMiddle() {
+	RubiksCube cube = RubiksCube();
+
+	Lookup lookup;
+	std::string title = "newHashMap2CornersConstructedDepth7";
+	Lookup::load(lookup.newHashMap2Corner, title);
+	lookup.buildIndexes();
+	lookup.makeDistanceTables2Corner();
+	std::cout << "Finished loading maps." << "\n";
+
+	unsigned long totNumMoves = 0;
+
+	int num_test = 100;
+	auto now = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < num_test; i++) {
+		cube.shuffle(50);
+		auto solvingMoves = Solver::solveUpTo2CornersMeetInTheMiddle(cube, lookup);
+		totNumMoves += solvingMoves.size();
+	}
+	std::cout << "Solved " << num_test << " cubes, avg number of moves: " << static_cast<double>(totNumMoves) / static_cast<double>(num_test) << ".\n";
+
+	auto after = std::chrono::high_resolution_clock::now();
+	auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+	std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+	<< "\n";
+}
+
+void testNumSolvingMovesTwoCornerIDAStar() {
+	RubiksCube cube = RubiksCube();
+
+	Lookup lookup;
+	lookup.makeDistanceTables2Corner();
+	std::cout << "Finished loading tables." << "\n";
+
+	unsigned long totNumMoves = 0;
+
+	int num_test = 100;
+	auto now = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < num_test; i++) {
+		cube.shuffle(50);
+		auto solvingMoves = Solver::solveUpTo2CornersUsingIDAStar(cube, lookup);
+		totNumMoves += solvingMoves.size();
+	}
+	std::cout << "Solved " << num_test << " cubes, avg number of moves: " << static_cast<double>(totNumMoves) / static_cast<double>(num_test) << ".\n";
+
+	auto after = std::chrono::high_resolution_clock::now();
+	auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+	std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+	<< "\n";
+}
+
+void testTwoPhaseSolver() {
+	RubiksCube cube = RubiksCube();
+	TwoPhaseSolver::tables();
+	std::cout << "Finished loading tables." << "\n";
+
+	for (const int targetLength : {21, 20}) {
+		unsigned long totNumMoves = 0;
+
+		int num_test = 100;
+		auto now = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < num_test; i++) {
+			cube.shuffle(50);
+			auto solvingMoves = TwoPhaseSolver::solve(cube, targetLength);
+			totNumMoves += solvingMoves.size();
+		}
+		std::cout << "Target " << targetLength << ": solved " << num_test << " cubes, avg number of moves: " << static_cast<double>(totNumMoves) / static_cast<double>(num_test) << ".\n";
+
+		auto after = std::chrono::high_resolution_clock::now();
+		auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+		std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+		<< "\n";
+	}
+}
+
+void testNumSolvingMovesTwoCornerParentMoves() {
+	RubiksCube cube = RubiksCube();
+
+	Lookup lookup;
+	std::string title = "newHashMap2CornersConstructedDepth7";
+	Lookup::load(lookup.newHashMap2Corner, title);
+	std::cout << "Finished loading maps." << "\n";
+
+	const auto mapSize = lookup.newHashMap2Corner.size();
+	lookup.buildParentTables();
+	std::cout << "Parent table for " << mapSize << " states uses " << lookup.newHashParents2Corner.memoryUsage() / 1000 << "kB.\n";
+
+	unsigned long totNumMoves = 0;
+
+	int num_test = 100;
+	auto now = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < num_test; i++) {
+		cube.shuffle(50);
+		auto solvingMoves = Solver::solveUpTo2CornersUsingNewHash(cube, lookup, 4);
+		totNumMoves += solvingMoves.size();
+	}
+	std::cout << "Solved " << num_test << " cubes, avg number of moves: " << static_cast<double>(totNumMoves) / static_cast<double>(num_test) << ".\n";
+
+	auto after = std::chrono::high_resolution_clock::now();
+	auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+	std::cout << "Total time: " << totTime << " | Avg time: " << static_cast<double>(totTime) / static_cast<double>(num_test)
+	<< "\n";
+}
+
+void testMoveTableGenerationSpeed() {
+	const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+	for (const unsigned workers : {1u, cores}) {
+		auto now = std::chrono::high_resolution_clock::now();
+		auto table = CoordinateMoveTable::generate(CoordinateConst::crossEdges, workers);
+		auto after = std::chrono::high_resolution_clock::now();
+
+		auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+		std::cout << "Move table with " << table.next.size() << " entries on " << workers << " workers: " << totTime << "ms\n";
+	}
+}
+
+void testTableGenerationSpeed() {
+	const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+	for (const unsigned workers : {1u, cores}) {
+		Lookup lookup;
+		auto now = std::chrono::high_resolution_clock::now();
+		lookup.generateLookupNewHash2Corner(6, workers);
+		auto after = std::chrono::high_resolution_clock::now();
+
+		auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+		std::cout << "Depth 6 table with " << lookup.newHashMap2Corner.size() << " states on " << workers << " workers: " << totTime << "ms\n";
+	}
+}
+
+void testBreadthFirstGenerationSpeed() {
+	Lookup lookup;
+
+	auto now = std::chrono::high_resolution_clock::now();
+	lookup.generateLookupCoordinate2Corner(6);
+	auto after = std::chrono::high_resolution_clock::now();
+	std::cout << "Depth first: " << std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count() << "ms\n";
+
+	now = std::chrono::high_resolution_clock::now();
+	lookup.generateLookupCoordinate2CornerBreadthFirst(6);
+	after = std::chrono::high_resolution_clock::now();
+	std::cout << "Breadth first: " << std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count() << "ms\n";
+}
+
+void testExternalTableBuild() {
+	Lookup lookup;
+
+	auto now = std::chrono::high_resolution_clock::now();
+	lookup.generateLookupNewHash2Corner(6);
+	auto after = std::chrono::high_resolution_clock::now();
+	std::cout << "In memory: " << std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count() << "ms\n";
+
+	now = std::chrono::high_resolution_clock::now();
+	Lookup::generateLookupNewHash2CornerOnDisk(6, 1 << 20);
+	after = std::chrono::high_resolution_clock::now();
+	std::cout << "On disk: " << std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count() << "ms\n";
+
+	Lookup mapped;
+	mapped.openNewHashTable2Corner("newHashMap2CornersConstructedDepth6");
+	const auto &table = mapped.newHashTable2Corner;
+	size_t numDifferent = 0;
+	for (const auto &[key, moves] : lookup.newHashMap2Corner) {
+		const auto found = table.find(key);
+		if (!found || found->size() != moves.size()) { numDifferent++; }
+	}
+	std::cout << "Keys: " << table.size() << ", different: " << numDifferent << "\n";
+}
+
+void testTableExtension() {
+	Lookup lookup;
+	lookup.generateLookupCoordinate2CornerBreadthFirst(6);
+
+	auto now = std::chrono::high_resolution_clock::now();
+	lookup.generateLookupCoordinate2CornerBreadthFirst(7);
+	auto after = std::chrono::high_resolution_clock::now();
+	std::cout << "From solved: " << std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count() << "ms\n";
+
+	now = std::chrono::high_resolution_clock::now();
+	lookup.extendLookupCoordinate2Corner(6, 7);
+	after = std::chrono::high_resolution_clock::now();
+	std::cout << "From depth 6: " << std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count() << "ms\n";
+}
+
+void testDistanceTables() {
+	for (const int bits : {4, 2}) {
+		Lookup lookup;
+		lookup.makeDistanceTables2Corner(bits);
+
+		RubiksCube cube = RubiksCube();
+		int num_test = 10000;
+		int sum = 0;
+		auto now = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < num_test; i++) {
+			cube.shuffle(50);
+			sum += lookup.distance2Corner(CrossAnd2CornersCoordinates{CubieCube(cube)});
+		}
+		auto after = std::chrono::high_resolution_clock::now();
+
+		std::cout << bits << " bits: " << (lookup.crossCornersDistance.memoryUsage() + lookup.crossSlotEdgesDistance.memoryUsage()) / 1000 / 1000 << "MB, ";
+		std::cout << "average lower bound " << static_cast<double>(sum) / num_test << " in ";
+		std::cout << std::chrono::duration_cast<std::chrono::microseconds>(after - now).count() << "us\n";
+	}
+}
+
+void testParallelSearch() {
+	RubiksCube cube = RubiksCube();
+
+	Lookup lookup;
+	std::string title = "newHashMap2CornersConstructedDepth7";
+	Lookup::load(lookup.newHashMap2Corner, title);
+	lookup.buildIndexes();
+	std::cout << "Finished loading maps." << "\n";
+
+	const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+	int num_test = 20;
+	for (const unsigned workers : {1u, cores}) {
+		const ParallelSearch parallel{workers, 3};
+
+		auto now = std::chrono::high_resolution_clock::now();
+		size_t numSolutions = 0;
+		for (int i = 0; i < num_test; i++) {
+			cube.shuffle(50, false, i);
+			numSolutions += Solver::findCrossAnd2CornersUsingNewHash(cube, lookup, 5, parallel).size();
+		}
+
+		auto after = std::chrono::high_resolution_clock::now();
+		auto totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+		std::cout << workers << " workers: " << numSolutions << " solutions | Total time: " << totTime << "ms | Avg time: "
+		<< static_cast<double>(totTime) / static_cast<double>(num_test) << "ms\n";
+	}
+}
+
 void compareLookupSpeed() {
 	Lookup lookup;
 	RubiksCube cube;
@@ -352,6 +688,19 @@ void compareLookupSpeed() {
 	totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
 	std::cout << "Total time (new): " << totTime << "ms | Avg time: " << static_cast<double>(totTime) / static_cast<double>(numTests)
 	<< "ms\n";
+
+	lookup.buildIndexes();
+	now = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numTests; i++) {
+		cube.shuffle(5);
+		auto h0 = cube.hashNew2Corner();
+		auto b0 = lookup.newHashIndex2Corner.contains(h0);
+	}
+
+	after = std::chrono::high_resolution_clock::now();
+	totTime = std::chrono::duration_cast<std::chrono::milliseconds>(after - now).count();
+	std::cout << "Total time (flat index): " << totTime << "ms | Avg time: " << static_cast<double>(totTime) / static_cast<double>(numTests)
+	<< "ms | Memory: " << lookup.newHashIndex2Corner.memoryUsage() / 1000 << "kB\n";
 }
 
 void testMoveSpeed() {
@@ -359,18 +708,174 @@ void testMoveSpeed() {
 	const unsigned long long numCycles = 1 * MILLION;
 	const unsigned long long numMoves = numCycles * RubiksConst::everyMove.size();
 
-	const auto t0 = std::chrono::high_resolution_clock::now();
-	for (const auto m : RubiksConst::everyMove) {
-		for (int i = 0; i < numCycles; i++) {
-			cube.turn(m);
+	for (const auto engine : {HandWritten, PermutationTable}) {
+		RubiksCube::turnEngine = engine;
+
+		const auto t0 = std::chrono::high_resolution_clock::now();
+		for (const auto m : RubiksConst::everyMove) {
+			for (int i = 0; i < numCycles; i++) {
+				cube.turn(m);
+			}
+		}
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		const auto totTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+		std::cout << (engine == HandWritten ? "Hand written | " : "Permutation table | ");
+		std::cout << "Total time for " << numMoves << " moves: " << totTime / 1000 << "ms | Avg time: " << static_cast<double>(totTime) / static_cast<double>(numMoves)
+		<< "us\n";
+	}
+	RubiksCube::turnEngine = PermutationTable;
+
+	// Total time for 18000000 moves: 137ms | Avg time: 0.00762217us (Old, without hashing)
+}
+
+void confirmSameTurns() {
+	RubiksCube handWritten;
+	RubiksCube table;
+
+	int numMoves = 10 * MILLION;
+	for (int i = 0; i < numMoves; i++) {
+		const auto moveIndex = static_cast<int>(mix64(i) % 18);
+
+		RubiksCube::turnEngine = HandWritten;
+		handWritten.turnIndex(moveIndex);
+		RubiksCube::turnEngine = PermutationTable;
+		table.turnIndex(moveIndex);
+
+		if (handWritten.cube != table.cube) {
+			std::cout << "Turn engines disagree after " << i << " moves.\n";
+			return;
 		}
 	}
+
+	std::cout << "For " << numMoves << " moves, the turn engines are equal." << "\n";
+}
+
+void testPackedMoveSpeed() {
+	PackedCube cube;
+	const unsigned long long numCycles = 1 * MILLION;
+	const unsigned long long numMoves = numCycles * RubiksConst::everyMove.size();
+
+	const auto t0 = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numMoves; i++) {
+		cube.turnIndex(static_cast<int>(mix64(i) % 18));
+	}
 	const auto t1 = std::chrono::high_resolution_clock::now();
 	const auto totTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
-	std::cout << "Total time for " << numMoves << " moves: " << totTime / 1000 << "ms | Avg time: " << static_cast<double>(totTime) / static_cast<double>(numMoves)
+	std::cout << "Packed | Total time for " << numMoves << " moves: " << totTime / 1000 << "ms | Avg time: " << static_cast<double>(totTime) / static_cast<double>(numMoves)
 	<< "us\n";
 
-	// Total time for 18000000 moves: 137ms | Avg time: 0.00762217us (Old, without hashing)
+	RubiksCube reference;
+	reference.cube = cube.toArray();
+	if (!(PackedCube(reference) == cube)) {
+		std::cout << "Conversion between packed and array cube is broken.\n";
+	}
+}
+
+void testCubieMoveSpeed() {
+	CubieCube cube;
+	const unsigned long long numCycles = 1 * MILLION;
+	const unsigned long long numMoves = numCycles * RubiksConst::everyMove.size();
+
+	uint64_t combined = 0;
+	const auto t0 = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numMoves; i++) {
+		cube.turnIndex(static_cast<int>(mix64(i) % 18));
+		combined ^= CrossAnd2CornersCoordinates(cube).key();
+	}
+	const auto t1 = std::chrono::high_resolution_clock::now();
+	const auto totTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+	std::cout << "Cubie | Total time for " << numMoves << " moves + keys: " << totTime / 1000 << "ms | Avg time: " << static_cast<double>(totTime) / static_cast<double>(numMoves)
+	<< "us | " << combined << "\n";
+
+	RubiksCube reference;
+	for (int i = 0; i < numMoves; i++) {
+		reference.turnIndex(static_cast<int>(mix64(i) % 18));
+	}
+	if (CubieCube(reference) != cube || cube.toArray() != reference.cube) {
+		std::cout << "Conversion between cubie and facelet cube is broken.\n";
+	}
+}
+
+void testIncrementalHashSpeed() {
+	RubiksCube cube;
+	HashedCube hashed(cube);
+	const unsigned long long numMoves = 10 * MILLION;
+
+	__int128 combined = 0;
+	const auto t0 = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numMoves; i++) {
+		cube.turnIndex(static_cast<int>(mix64(i) % 18));
+		combined ^= cube.hashNew2Corner();
+	}
+	const auto t1 = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numMoves; i++) {
+		hashed.turnIndex(static_cast<int>(mix64(i) % 18));
+		combined ^= hashed.hash;
+	}
+	const auto t2 = std::chrono::high_resolution_clock::now();
+
+	std::cout << "Turn + full hash: " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << "ms\n";
+	std::cout << "Turn + incremental hash: " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms\n";
+	if (combined != 0) {
+		std::cout << "Incremental hash differs from hashNew2Corner.\n";
+	}
+}
+
+void testCoordinateSpeed() {
+	const auto &coordinate = CoordinateConst::crossAnd2Corners;
+	CubieCube cube;
+	const unsigned long long numMoves = 10 * MILLION;
+
+	uint64_t combined = 0;
+	int numWrong = 0;
+	const auto t0 = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numMoves; i++) {
+		cube.turnIndex(static_cast<int>(mix64(i) % 18));
+		const auto rank = coordinate.rank(cube);
+		combined ^= rank;
+
+		if (i % 1000 == 0 && coordinate.rank(coordinate.unrank(rank)) != rank) {
+			numWrong++;
+		}
+	}
+	const auto t1 = std::chrono::high_resolution_clock::now();
+
+	std::cout << "Turn + rank of " << numMoves << " states (coordinate space " << coordinate.size() << "): " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+	<< "ms | Wrong round trips: " << numWrong << " | " << combined << "\n";
+}
+
+void testKernelLevels() {
+	const auto detected = CpuDispatch::detect();
+	const auto active = CpuDispatch::level();
+	const unsigned long long numMoves = 10 * MILLION;
+
+	__int128 expected = 0;
+	for (const auto level : {Scalar, SSE4, AVX2, AVX512}) {
+		if (level > detected) {
+			std::cout << CpuDispatch::name(level) << " | Not supported by this CPU.\n";
+			continue;
+		}
+		CpuDispatch::force(level);
+
+		PackedCube cube;
+		__int128 combined = 0;
+		const auto t0 = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < numMoves; i++) {
+			cube.turnIndex(static_cast<int>(mix64(i) % 18));
+			combined ^= cube.hashNew2Corner();
+		}
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		const auto totTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+		std::cout << CpuDispatch::name(level) << " | Turn + hash for " << numMoves << " moves: " << totTime / 1000 << "ms\n";
+
+		if (level == Scalar) {
+			expected = combined;
+		} else if (combined != expected) {
+			std::cout << CpuDispatch::name(level) << " | Hashes differ from the scalar kernels.\n";
+		}
+	}
+
+	CpuDispatch::force(active);
 }
 
 int main() {
@@ -414,12 +919,32 @@ int main() {
 	// confirmSameResult();
 	// testHashingSpeed();
 	// testMoveSpeed();
+	// confirmSameTurns();
+	// testPackedMoveSpeed();
+	// testKernelLevels();
+	// testCubieMoveSpeed();
+	// testIncrementalHashSpeed();
+	// testCoordinateSpeed();
 	// confirmSameResultNew();
 	// testNewHashingSpeed();
 	// testNumSolvingMoves();
 	// testSolving3Corners();
+	// testSolveModes();
 	// confirmSameResultNewVsOld();
 
 	//testNumSolvingMovesTwoCornerNewHash();
+	// testNumSolvingMovesTwoCornerArena();
+	// testNumSolvingMovesTwoCornerCoordinates();
+	// testNumSolvingMovesTwoCornerParentMoves();
+	// testNumSolvingMovesTwoCornerMeetInTheMiddle();
+	// testNumSolvingMovesTwoCornerIDAStar();
+	// testTwoPhaseSolver();
+	// testParallelSearch();
+	// testMoveTableGenerationSpeed();
+	// testTableGenerationSpeed();
+	// testBreadthFirstGenerationSpeed();
+	// testExternalTableBuild();
+	// testTableExtension();
+	// testDistanceTables();
 	// compareLookupSpeed();
 }